@@ -0,0 +1,161 @@
+#ifndef RD_CPP_CORE_ACTIONLIST_H
+#define RD_CPP_CORE_ACTIONLIST_H
+
+#include "util/unique_function.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+/**
+ * \brief Termination actions of a \ref LifetimeImpl, kept in the order they were added. Actions are stored in one growing
+ * array of slots linked by index, and removed slots are reused, so adding and removing by handle are O(1) and an action
+ * whose captures fit util::unique_function doesn't allocate. A handle carries the generation of its slot, removing
+ * an action which already ran or was removed does nothing. Not synchronized, the lifetime guards it with its own lock.
+ */
+class ActionList
+{
+public:
+	using handle_t = int64_t;
+
+private:
+	static constexpr uint32_t NIL = (std::numeric_limits<uint32_t>::max)();
+	// kept below 2^31 so that handles are non-negative
+	static constexpr uint32_t GENERATION_MASK = 0x7fffffff;
+
+	struct Slot
+	{
+		util::unique_function<void()> action;
+		uint32_t prev = NIL;
+		// next slot in the list, or in the free list for a removed slot
+		uint32_t next = NIL;
+		uint32_t generation = 0;
+	};
+
+	std::vector<Slot> slots;
+	uint32_t tail = NIL;
+	uint32_t free_head = NIL;
+	size_t count = 0;
+
+public:
+	// region ctor/dtor
+
+	ActionList() = default;
+
+	ActionList(ActionList const&) = delete;
+
+	ActionList& operator=(ActionList const&) = delete;
+
+	ActionList(ActionList&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	ActionList& operator=(ActionList&& other) noexcept
+	{
+		if (this != &other)
+		{
+			slots = std::move(other.slots);
+			tail = other.tail;
+			free_head = other.free_head;
+			count = other.count;
+			other.slots.clear();
+			other.tail = NIL;
+			other.free_head = NIL;
+			other.count = 0;
+		}
+		return *this;
+	}
+	// endregion
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	handle_t add(util::unique_function<void()> action)
+	{
+		uint32_t index = free_head;
+		if (index == NIL)
+		{
+			index = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}
+		else
+		{
+			free_head = slots[index].next;
+		}
+
+		Slot& slot = slots[index];
+		slot.action = std::move(action);
+		slot.prev = tail;
+		slot.next = NIL;
+		if (tail != NIL)
+		{
+			slots[tail].next = index;
+		}
+		tail = index;
+		++count;
+		return (static_cast<handle_t>(slot.generation) << 32) | index;
+	}
+
+	/**
+	 * \return false if [handle] doesn't refer to an action of the list.
+	 */
+	bool remove(handle_t handle)
+	{
+		if (handle < 0)
+		{
+			return false;
+		}
+		const uint32_t index = static_cast<uint32_t>(handle);
+		if (index >= slots.size() || slots[index].generation != static_cast<uint32_t>(handle >> 32))
+		{
+			return false;
+		}
+
+		Slot& slot = slots[index];
+		if (slot.prev != NIL)
+		{
+			slots[slot.prev].next = slot.next;
+		}
+		if (slot.next == NIL)
+		{
+			tail = slot.prev;
+		}
+		else
+		{
+			slots[slot.next].prev = slot.prev;
+		}
+		slot.action = nullptr;
+		slot.generation = (slot.generation + 1) & GENERATION_MASK;
+		slot.prev = NIL;
+		slot.next = free_head;
+		free_head = index;
+		--count;
+		return true;
+	}
+
+	/**
+	 * \brief Invokes the actions from the last added to the first. The list must be detached from its lifetime first,
+	 * actions may terminate other lifetimes which remove their actions from it.
+	 */
+	void run_reversed()
+	{
+		for (uint32_t index = tail; index != NIL; index = slots[index].prev)
+		{
+			slots[index].action();
+		}
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_CORE_ACTIONLIST_H
@@ -21,19 +21,14 @@ void LifetimeImpl::terminate()
 
 	// region thread-safety section
 
-	actions_t actions_copy;
+	ActionList actions_copy;
 	{
 		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
 		actions_copy = std::move(actions);
-
-		actions.clear();
 	}
 	// endregion
 
-	for (auto it = actions_copy.rbegin(); it != actions_copy.rend(); ++it)
-	{
-		it->second();
-	}
+	actions_copy.run_reversed();
 }
 
 bool LifetimeImpl::is_terminated() const
@@ -51,9 +46,8 @@ void LifetimeImpl::attach_nested(std::shared_ptr<LifetimeImpl> nested)
 	if (nested->is_terminated() || is_eternal())
 		return;
 
-	std::function<void()> action = [nested] { nested->terminate(); };
-	counter_t action_id = add_action(action);
-	nested->add_action([this, id = action_id] { actions.erase(id); });
+	counter_t action_id = add_action([nested] { nested->terminate(); });
+	nested->add_action([this, id = action_id] { remove_action(id); });
 }
 
 LifetimeImpl::~LifetimeImpl()
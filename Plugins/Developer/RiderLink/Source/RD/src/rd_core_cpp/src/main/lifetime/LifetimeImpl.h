@@ -6,6 +6,8 @@
 #pragma warning(disable:4251)
 #endif
 
+#include "ActionList.h"
+
 #include <std/hash.h>
 
 #include <functional>
@@ -28,7 +30,8 @@ public:
 
 	friend class Lifetime;
 
-	using counter_t = int32_t;
+	// wide enough for action handles, see ActionList
+	using counter_t = int64_t;
 
 private:
 	bool eternaled = false;
@@ -36,9 +39,7 @@ private:
 
 	counter_t id = 0;
 
-	counter_t action_id_in_map = 0;
-	using actions_t = ordered_map<int, std::function<void()>, rd::hash<int>>;
-	actions_t actions;
+	ActionList actions;
 
 	void terminate();
 
@@ -67,15 +68,14 @@ public:
 			throw std::invalid_argument("Already Terminated");
 		}
 
-		actions[action_id_in_map] = std::forward<F>(action);
-		return action_id_in_map++;
+		return actions.add(std::forward<F>(action));
 	}
 
 	void remove_action(counter_t i)
 	{
 		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
 
-		actions.erase(i);
+		actions.remove(i);
 	}
 
 #if __cplusplus >= 201703L
@@ -0,0 +1,210 @@
+#ifndef RD_CPP_UNIQUE_FUNCTION_H
+#define RD_CPP_UNIQUE_FUNCTION_H
+
+#include "core_traits.h"
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+template <typename Signature>
+class unique_function;
+
+/**
+ * \brief Move-only counterpart of std::function. Callables of up to INLINE_SIZE bytes which move without throwing are
+ * stored in place, so a task capturing a few pointers and a Buffer doesn't allocate. Bigger ones are moved to the heap.
+ * Unlike std::function it accepts move-only callables, and any std::function converts to it.
+ */
+template <typename R, typename... Args>
+class unique_function<R(Args...)>
+{
+public:
+	static constexpr size_t INLINE_SIZE = 64;
+
+private:
+	struct ops_t
+	{
+		R (*invoke)(void* storage, Args&&... args);
+		// moves the callable to uninitialized [to] and destroys the one left in [from]
+		void (*relocate)(void* from, void* to);
+		void (*destroy)(void* storage);
+	};
+
+	template <typename F>
+	struct inline_ops
+	{
+		static R invoke(void* storage, Args&&... args)
+		{
+			return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+		}
+
+		static void relocate(void* from, void* to)
+		{
+			F* f = static_cast<F*>(from);
+			::new (to) F(std::move(*f));
+			f->~F();
+		}
+
+		static void destroy(void* storage)
+		{
+			static_cast<F*>(storage)->~F();
+		}
+
+		static ops_t const* get()
+		{
+			static const ops_t ops{&invoke, &relocate, &destroy};
+			return &ops;
+		}
+	};
+
+	template <typename F>
+	struct heap_ops
+	{
+		static R invoke(void* storage, Args&&... args)
+		{
+			return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+		}
+
+		static void relocate(void* from, void* to)
+		{
+			::new (to) F*(*static_cast<F**>(from));
+		}
+
+		static void destroy(void* storage)
+		{
+			delete *static_cast<F**>(storage);
+		}
+
+		static ops_t const* get()
+		{
+			static const ops_t ops{&invoke, &relocate, &destroy};
+			return &ops;
+		}
+	};
+
+	template <typename F>
+	using stored_inline = std::integral_constant<bool, sizeof(F) <= INLINE_SIZE &&
+														   alignof(std::max_align_t) % alignof(F) == 0 &&
+														   std::is_nothrow_move_constructible<F>::value>;
+
+	alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+	ops_t const* ops = nullptr;
+
+	template <typename F>
+	static bool is_null(F const&)
+	{
+		return false;
+	}
+
+	template <typename Signature>
+	static bool is_null(std::function<Signature> const& f)
+	{
+		return !f;
+	}
+
+	template <typename T>
+	static bool is_null(T* const& f)
+	{
+		return f == nullptr;
+	}
+
+	template <typename F>
+	void emplace(F&& f, std::true_type /*stored_inline*/)
+	{
+		::new (static_cast<void*>(storage)) std::decay_t<F>(std::forward<F>(f));
+		ops = inline_ops<std::decay_t<F>>::get();
+	}
+
+	template <typename F>
+	void emplace(F&& f, std::false_type /*stored_inline*/)
+	{
+		::new (static_cast<void*>(storage)) std::decay_t<F>*(new std::decay_t<F>(std::forward<F>(f)));
+		ops = heap_ops<std::decay_t<F>>::get();
+	}
+
+	void reset()
+	{
+		if (ops != nullptr)
+		{
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+public:
+	// region ctor/dtor
+
+	unique_function() = default;
+
+	unique_function(std::nullptr_t)
+	{
+	}
+
+	template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, unique_function>::value &&
+							  is_invocable_r<R, std::decay_t<F>&, Args...>::value>>
+	unique_function(F&& f)
+	{
+		if (!is_null(f))
+		{
+			emplace(std::forward<F>(f), stored_inline<std::decay_t<F>>());
+		}
+	}
+
+	unique_function(unique_function const&) = delete;
+
+	unique_function& operator=(unique_function const&) = delete;
+
+	unique_function(unique_function&& other) noexcept : ops(other.ops)
+	{
+		if (ops != nullptr)
+		{
+			ops->relocate(other.storage, storage);
+			other.ops = nullptr;
+		}
+	}
+
+	unique_function& operator=(unique_function&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.ops != nullptr)
+			{
+				other.ops->relocate(other.storage, storage);
+				ops = other.ops;
+				other.ops = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	~unique_function()
+	{
+		reset();
+	}
+	// endregion
+
+	explicit operator bool() const
+	{
+		return ops != nullptr;
+	}
+
+	R operator()(Args... args)
+	{
+		if (ops == nullptr)
+		{
+			throw std::bad_function_call();
+		}
+		return ops->invoke(storage, std::forward<Args>(args)...);
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_UNIQUE_FUNCTION_H
@@ -0,0 +1,39 @@
+#ifndef RD_CPP_FRAMEWORK_IRDSNAPSHOTABLE_H
+#define RD_CPP_FRAMEWORK_IRDSNAPSHOTABLE_H
+
+#include "protocol/Buffer.h"
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief A reactive entity whose whole state can be written at once and restored on its remote copy, see \ref
+ * write_snapshot(RdBindableBase const&, int64_t, Buffer&).
+ */
+class RD_FRAMEWORK_API IRdSnapshotable
+{
+public:
+	// region ctor/dtor
+
+	IRdSnapshotable() = default;
+
+	virtual ~IRdSnapshotable() = default;
+	// endregion
+
+	/**
+	 * \brief Writes the current state of the entity.
+	 * \param buffer to write the state to
+	 */
+	virtual void write_snapshot(Buffer& buffer) const = 0;
+
+	/**
+	 * \brief Replaces the state of the entity with the one written by \ref write_snapshot on the counterpart.
+	 * Local subscribers are notified of the changes as if they were received from the wire, nothing is sent back.
+	 * \param buffer to read the state from
+	 */
+	virtual void apply_snapshot(Buffer& buffer) const = 0;
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_FRAMEWORK_IRDSNAPSHOTABLE_H
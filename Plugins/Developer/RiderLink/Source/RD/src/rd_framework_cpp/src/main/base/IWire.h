@@ -40,6 +40,27 @@ public:
 	 */
 	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const = 0;
 
+	/**
+	 * \brief Same as \ref send, but the wire may reserve space for the message at once.
+	 * \param size_hint expected number of bytes written by [writer], 0 if unknown.
+	 */
+	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer, size_t /*size_hint*/) const
+	{
+		send(id, std::move(writer));
+	}
+
+	/**
+	 * \brief Same as \ref send for messages too large to be built in memory at once. [writer] calls the flush function
+	 * it's given after each complete part of the data, the wire may then send the bytes written so far as a fragment
+	 * of the message and continue in an empty buffer. The receiver dispatches the message once all of it has arrived.
+	 * Positions in the buffer must not be kept across a flush.
+	 */
+	virtual void send_fragmented(
+		RdId const& id, std::function<void(Buffer& buffer, std::function<void()> const& flush)> writer) const
+	{
+		send(id, [&writer](Buffer& buffer) { writer(buffer, [] {}); });
+	}
+
 	/**
 	 * \brief Adds a [handler] for receiving updated values of the object with the given [id]. The handler is removed
 	 * when the given [lifetime] is terminated.
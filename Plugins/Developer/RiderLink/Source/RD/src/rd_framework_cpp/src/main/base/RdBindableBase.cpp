@@ -22,8 +22,25 @@ void RdBindableBase::bind(Lifetime lf, IRdDynamic const* parent, string_view nam
 			this->parent = parent;
 			location = parent->get_location().sub(name, ".");
 			this->bind_lifetime = lf;
+			bound_owner = dynamic_cast<RdBindableBase const*>(parent);
+			if (bound_owner != nullptr)
+			{
+				prev_bound_sibling = bound_owner->last_bound_child;
+				(prev_bound_sibling != nullptr ? prev_bound_sibling->next_bound_sibling : bound_owner->first_bound_child) = this;
+				bound_owner->last_bound_child = this;
+			}
 		},
 		[this, lf]() {
+			if (bound_owner != nullptr)
+			{
+				(prev_bound_sibling != nullptr ? prev_bound_sibling->next_bound_sibling : bound_owner->first_bound_child) =
+					next_bound_sibling;
+				(next_bound_sibling != nullptr ? next_bound_sibling->prev_bound_sibling : bound_owner->last_bound_child) =
+					prev_bound_sibling;
+				prev_bound_sibling = nullptr;
+				next_bound_sibling = nullptr;
+				bound_owner = nullptr;
+			}
 			this->bind_lifetime = lf;
 			location = location.sub("<<unbound>>", "::");
 			this->parent = nullptr;
@@ -66,6 +83,16 @@ const RName& RdBindableBase::get_location() const
 	return location;
 }
 
+RdBindableBase const* RdBindableBase::get_first_bound_child() const
+{
+	return first_bound_child;
+}
+
+RdBindableBase const* RdBindableBase::get_next_bound_sibling() const
+{
+	return next_bound_sibling;
+}
+
 RdId RdBindableBase::get_id() const
 {
 	return rdid;
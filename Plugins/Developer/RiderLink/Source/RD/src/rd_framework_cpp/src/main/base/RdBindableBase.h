@@ -24,6 +24,14 @@ protected:
 
 	mutable optional<Lifetime> bind_lifetime;
 
+	// the bindable this is bound to, and an intrusive list of the ones bound to this in binding order, so that
+	// a child unlinks itself in O(1) when unbound
+	mutable RdBindableBase const* bound_owner = nullptr;
+	mutable RdBindableBase const* first_bound_child = nullptr;
+	mutable RdBindableBase const* last_bound_child = nullptr;
+	mutable RdBindableBase const* prev_bound_sibling = nullptr;
+	mutable RdBindableBase const* next_bound_sibling = nullptr;
+
 	bool is_bound() const;
 
 	const IProtocol* get_protocol() const override;
@@ -59,6 +67,17 @@ public:
 
 	SerializationCtx& get_serialization_context() const override;
 
+	/**
+	 * \brief First of the bindables currently bound with this as their parent, nullptr if there are none. The others
+	 * follow it in binding order, see \ref get_next_bound_sibling.
+	 */
+	RdBindableBase const* get_first_bound_child() const;
+
+	/**
+	 * \brief Bindable bound to the same parent right after this one, nullptr for the last one.
+	 */
+	RdBindableBase const* get_next_bound_sibling() const;
+
 	mutable ordered_map<std::string, std::shared_ptr<IRdBindable>> bindable_extensions;	   // TO-DO concurrency
 	// mutable std::map<std::string, std::any> non_bindable_extensions;//TO-DO concurrency
 
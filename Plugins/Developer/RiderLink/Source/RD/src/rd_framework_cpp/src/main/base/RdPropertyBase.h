@@ -2,6 +2,7 @@
 #define RD_CPP_RDPROPERTYBASE_H
 
 #include "base/RdReactiveBase.h"
+#include "base/IRdSnapshotable.h"
 #include "serialization/Polymorphic.h"
 #include "reactive/Property.h"
 
@@ -13,7 +14,7 @@
 namespace rd
 {
 template <typename T, typename S = Polymorphic<T>>
-class RdPropertyBase : public RdReactiveBase, public Property<T>
+class RdPropertyBase : public RdReactiveBase, public Property<T>, public IRdSnapshotable
 {
 protected:
 	using WT = typename IProperty<T>::WT;
@@ -78,12 +79,15 @@ public:
 			{
 				master_version++;
 			}
-			get_wire()->send(rdid, [this, &v](Buffer& buffer) {
-				buffer.write_integral<int32_t>(master_version);
-				S::write(this->get_serialization_context(), buffer, v);
-				spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
-					std::to_string(master_version), to_string(v));
-			});
+			get_wire()->send(
+				rdid,
+				[this, &v](Buffer& buffer) {
+					buffer.write_integral<int32_t>(master_version);
+					S::write(this->get_serialization_context(), buffer, v);
+					spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location),
+						to_string(rdid), std::to_string(master_version), to_string(v));
+				},
+				sizeof(int32_t) + estimate_serialized_size<S>(this->get_serialization_context(), v));
 		});
 
 		get_wire()->advise(lifetime, this);
@@ -104,6 +108,34 @@ public:
 		int32_t version = buffer.read_integral<int32_t>();
 		WT v = S::read(this->get_serialization_context(), buffer);
 
+		receive(version, std::move(v));
+	}
+
+	void write_snapshot(Buffer& buffer) const override
+	{
+		buffer.write_integral<int32_t>(master_version);
+		buffer.write_bool(this->has_value());
+		if (this->has_value())
+		{
+			S::write(this->get_serialization_context(), buffer, this->get());
+		}
+	}
+
+	void apply_snapshot(Buffer& buffer) const override
+	{
+		int32_t version = buffer.read_integral<int32_t>();
+		if (!buffer.read_bool())
+		{
+			return;
+		}
+		WT v = S::read(this->get_serialization_context(), buffer);
+
+		receive(version, std::move(v));
+	}
+
+protected:
+	void receive(int32_t version, WT v) const
+	{
 		bool rejected = is_master && version < master_version;
 		spdlog::get("logSend")->trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
 			master_version, version, to_string(v), (rejected ? ">> REJECTED" : ""));
@@ -116,6 +148,7 @@ public:
 		Property<T>::set(std::move(v));
 	}
 
+public:
 	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const override
 	{
 		if (is_bound())
@@ -1,7 +1,39 @@
 #include "WireBase.h"
 
+#include "protocol/BufferPool.h"
+
 namespace rd
 {
+constexpr int32_t WireBase::MAX_PACKAGE_SIZE;
+
+Buffer::ByteArray WireBase::write_message(RdId const& rd_id, std::function<void(Buffer& buffer)> const& writer,
+	size_t size_hint, Buffer::IntegralEncoding encoding, int32_t compact_flag)
+{
+	RD_ASSERT_MSG(!rd_id.isNull(), "id mustn't be null");
+
+	// small or unknown (0) hints still get the default size, which fits most of the messages
+	Buffer buffer(BufferPool::Instance().acquire(
+		(std::max)(BufferPool::DEFAULT_SIZE, sizeof(int32_t) + sizeof(RdId::hash_t) + sizeof(int16_t) + size_hint)));
+	buffer.write_integral<int32_t>(0);	  // placeholder for length
+	rd_id.write(buffer);				  // write id
+	buffer.write_integral<int16_t>(0);	  // placeholder for context
+	buffer.set_integral_encoding(encoding);
+	writer(buffer);	   // write rest
+
+	const int32_t len = static_cast<int32_t>(buffer.get_position());
+	const int32_t flags = buffer.get_integral_encoding() == Buffer::IntegralEncoding::Compact ? compact_flag : 0;
+
+	buffer.rewind();
+	buffer.write_integral<int32_t>((len - 4) | flags);
+	buffer.set_position(len);
+	return std::move(buffer).getRealArray();
+}
+
+void WireBase::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	send(rd_id, std::move(writer), 0);
+}
+
 void WireBase::advise(Lifetime lifetime, const RdReactiveBase* entity) const
 {
 	message_broker.advise_on(lifetime, entity);
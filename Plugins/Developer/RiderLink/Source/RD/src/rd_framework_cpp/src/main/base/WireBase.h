@@ -16,7 +16,21 @@ protected:
 
 	MessageBroker message_broker;
 
+	/**
+	 * \brief Serializes the message for [rd_id] written by [writer] into a pooled buffer reserved for [size_hint] bytes
+	 * and returns the package: length, id, context and the data in [encoding]. [compact_flag] is combined
+	 * with the length if the data is still in the compact encoding after [writer].
+	 */
+	static Buffer::ByteArray write_message(RdId const& rd_id, std::function<void(Buffer& buffer)> const& writer,
+		size_t size_hint, Buffer::IntegralEncoding encoding = Buffer::IntegralEncoding::Fixed, int32_t compact_flag = 0);
+
 public:
+	/**
+	 * \brief Upper bound of a package's length, a longer one announced by the counterpart is malformed
+	 * and mustn't make the wire allocate it.
+	 */
+	static constexpr int32_t MAX_PACKAGE_SIZE = 1 << 28;
+
 	// region ctor/dtor
 	explicit WireBase(IScheduler* scheduler) : scheduler(scheduler), message_broker(scheduler)
 	{
@@ -25,6 +39,10 @@ public:
 	virtual ~WireBase() = default;
 	// endregion
 
+	void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const override = 0;
+
 	virtual void advise(Lifetime lifetime, RdReactiveBase const* entity) const override;
 };
 }	 // namespace rd
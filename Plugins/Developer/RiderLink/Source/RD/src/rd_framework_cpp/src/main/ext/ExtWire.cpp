@@ -20,8 +20,11 @@ ExtWire::ExtWire()
 					// auto[id, payload] = std::move(sendQ.front());
 					auto it = std::move(sendQ.front());
 					sendQ.pop();
-					realWire->send(
-						it.first, [payload = std::move(it.second)](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+					// the payload was serialized before the real wire chose its encoding
+					realWire->send(it.first, [payload = std::move(it.second)](Buffer& buffer) {
+						buffer.set_integral_encoding(Buffer::IntegralEncoding::Fixed);
+						buffer.write_byte_array_raw(payload);
+					});
 				}
 			}
 		}
@@ -34,6 +37,11 @@ void ExtWire::advise(Lifetime lifetime, RdReactiveBase const* entity) const
 }
 
 void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	send(id, std::move(writer), 0);
+}
+
+void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const
 {
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
@@ -45,6 +53,23 @@ void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) c
 			return;
 		}
 	}
-	realWire->send(id, std::move(writer));
+	realWire->send(id, std::move(writer), size_hint);
+}
+
+void ExtWire::send_fragmented(
+	RdId const& id, std::function<void(Buffer& buffer, std::function<void()> const& flush)> writer) const
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (!sendQ.empty() || !connected.get())
+		{
+			// queued messages are replayed whole
+			Buffer buffer;
+			writer(buffer, [] {});
+			sendQ.emplace(id, buffer.getRealArray());
+			return;
+		}
+	}
+	realWire->send_fragmented(id, std::move(writer));
 }
 }	 // namespace rd
@@ -32,6 +32,11 @@ public:
 	void advise(Lifetime lifetime, RdReactiveBase const* entity) const override;
 
 	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send(RdId const& id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const override;
+
+	void send_fragmented(
+		RdId const& id, std::function<void(Buffer& buffer, std::function<void()> const& flush)> writer) const override;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
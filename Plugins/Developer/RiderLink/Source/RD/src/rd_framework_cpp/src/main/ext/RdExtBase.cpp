@@ -1,4 +1,5 @@
 #include "RdExtBase.h"
+#include "RdSnapshot.h"
 
 #include "lifetime/Lifetime.h"
 #include "base/RdPropertyBase.h"
@@ -7,6 +8,8 @@
 
 namespace rd
 {
+static constexpr char const* SNAPSHOT_EXTENSION = "snapshot";
+
 const IProtocol* RdExtBase::get_protocol() const
 {
 	return extProtocol ? extProtocol.get() : RdReactiveBase::get_protocol();
@@ -88,6 +91,16 @@ void RdExtBase::sendState(IWire const& wire, ExtState state) const
 	});
 }
 
+void RdExtBase::acceptSnapshots() const
+{
+	getOrCreateExtension<RdSnapshot>(SNAPSHOT_EXTENSION);
+}
+
+void RdExtBase::sendSnapshot() const
+{
+	getOrCreateExtension<RdSnapshot>(SNAPSHOT_EXTENSION).send();
+}
+
 void RdExtBase::traceMe(std::shared_ptr<spdlog::logger> logger, string_view message) const
 {
 	logger->trace("ext {} {}:: {}", to_string(location), to_string(rdid), std::string(message));
@@ -55,6 +55,19 @@ public:
 
 	void sendState(IWire const& wire, ExtState state) const;
 
+	/**
+	 * \brief Makes this ext apply the snapshots its counterpart sends with \ref sendSnapshot, ones which arrive before
+	 * are dropped. Exts don't carry the \ref RdSnapshot extension otherwise.
+	 */
+	void acceptSnapshots() const;
+
+	/**
+	 * \brief Sends the state of every property and collection of this ext to the counterpart in one message, it
+	 * replaces their state there if it accepts snapshots. Meant for counterparts which reconnect or join late, see
+	 * \ref acceptSnapshots.
+	 */
+	void sendSnapshot() const;
+
 	void traceMe(std::shared_ptr<spdlog::logger> logger, string_view message) const;
 };
 
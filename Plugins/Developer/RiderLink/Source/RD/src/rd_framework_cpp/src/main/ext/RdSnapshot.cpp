@@ -0,0 +1,139 @@
+#include "RdSnapshot.h"
+
+#include "ext/RdExtBase.h"
+#include "base/IWire.h"
+#include "std/unordered_map.h"
+
+namespace rd
+{
+namespace
+{
+using snapshot_index_t = rd::unordered_map<RdId, RdBindableBase const*>;
+
+// visits the subtree depth-first in binding order, parents before their children
+template <typename F>
+void for_each_snapshotable(RdBindableBase const& node, F&& action)
+{
+	if (auto snapshotable = dynamic_cast<IRdSnapshotable const*>(&node))
+	{
+		action(node, *snapshotable);
+	}
+	for (auto child = node.get_first_bound_child(); child != nullptr; child = child->get_next_bound_sibling())
+	{
+		for_each_snapshotable(*child, action);
+	}
+}
+
+void index_subtree(RdBindableBase const& node, snapshot_index_t& index)
+{
+	for_each_snapshotable(node, [&index](RdBindableBase const& it, IRdSnapshotable const&) { index[it.get_id()] = &it; });
+}
+
+void unindex_subtree(RdBindableBase const& node, snapshot_index_t& index)
+{
+	for_each_snapshotable(node, [&index](RdBindableBase const& it, IRdSnapshotable const&) { index.erase(it.get_id()); });
+}
+}	 // namespace
+
+void write_snapshot(RdBindableBase const& root, int64_t serialization_hash, Buffer& buffer)
+{
+	write_snapshot(root, serialization_hash, buffer, [] {});
+}
+
+void write_snapshot(
+	RdBindableBase const& root, int64_t serialization_hash, Buffer& buffer, std::function<void()> const& flush)
+{
+	buffer.write_integral<int64_t>(serialization_hash);
+
+	// counted ahead, the buffer may be flushed past the count
+	int32_t count = 0;
+	for_each_snapshotable(root, [&count](RdBindableBase const&, IRdSnapshotable const&) { ++count; });
+	buffer.write_integral<int32_t>(count);
+	for_each_snapshotable(root, [&buffer, &flush](RdBindableBase const& node, IRdSnapshotable const& snapshotable) {
+		node.get_id().write(buffer);
+
+		const size_t length_position = buffer.get_position();
+		buffer.write_integral<int32_t>(0);
+		const size_t state_position = buffer.get_position();
+		snapshotable.write_snapshot(buffer);
+		const size_t end_position = buffer.get_position();
+		buffer.set_position(length_position);
+		buffer.write_integral<int32_t>(static_cast<int32_t>(end_position - state_position));
+		buffer.set_position(end_position);
+		flush();
+	});
+}
+
+bool apply_snapshot(RdBindableBase const& root, int64_t serialization_hash, Buffer& buffer)
+{
+	const int64_t counterpart_hash = buffer.read_integral<int64_t>();
+	if (counterpart_hash != serialization_hash)
+	{
+		spdlog::get("logReceived")
+			->error("snapshot of {} rejected: serializationHash doesn't match, our: {}, counterpart: {}",
+				to_string(root.get_location()), serialization_hash, counterpart_hash);
+		return false;
+	}
+
+	const int32_t count = buffer.read_integral<int32_t>();
+	snapshot_index_t index;
+	index_subtree(root, index);
+	for (int32_t i = 0; i < count; ++i)
+	{
+		const RdId id = RdId::read(buffer);
+		const int32_t length = buffer.read_integral<int32_t>();
+		RD_ASSERT_THROW_MSG(length >= 0, "snapshot of " + to_string(id) + " of negative length: " + std::to_string(length));
+		buffer.check_available(static_cast<size_t>(length));
+		const size_t end_position = buffer.get_position() + static_cast<size_t>(length);
+
+		auto it = index.find(id);
+		if (it != index.end())
+		{
+			// the entities below may be unbound and new ones bound by the state, e.g. a model set to a property,
+			// theirs follow it in the snapshot
+			RdBindableBase const* node = it->second;
+			for (auto child = node->get_first_bound_child(); child != nullptr; child = child->get_next_bound_sibling())
+			{
+				unindex_subtree(*child, index);
+			}
+			dynamic_cast<IRdSnapshotable const*>(node)->apply_snapshot(buffer);
+			for (auto child = node->get_first_bound_child(); child != nullptr; child = child->get_next_bound_sibling())
+			{
+				index_subtree(*child, index);
+			}
+		}
+		else
+		{
+			spdlog::get("logReceived")->trace("snapshot of {}:: no entity with id {}", to_string(root.get_location()), to_string(id));
+		}
+		buffer.set_position(end_position);
+	}
+	return true;
+}
+
+void RdSnapshot::init(Lifetime lifetime) const
+{
+	RdReactiveBase::init(lifetime);
+
+	get_wire()->advise(lifetime, this);
+}
+
+void RdSnapshot::send() const
+{
+	auto ext = dynamic_cast<RdExtBase const*>(bound_owner);
+	RD_ASSERT_MSG(ext != nullptr, "snapshot must be bound to an ext, location: " + to_string(location));
+
+	get_wire()->send_fragmented(rdid, [ext](Buffer& buffer, std::function<void()> const& flush) {
+		write_snapshot(*ext, ext->serializationHash, buffer, flush);
+	});
+}
+
+void RdSnapshot::on_wire_received(Buffer buffer) const
+{
+	auto ext = dynamic_cast<RdExtBase const*>(bound_owner);
+	RD_ASSERT_MSG(ext != nullptr, "snapshot must be bound to an ext, location: " + to_string(location));
+
+	spdlog::get("logReceived")->trace("RECV snapshot {} {}", to_string(location), to_string(rdid));
+	apply_snapshot(*ext, ext->serializationHash, buffer);
+}
+}	 // namespace rd
@@ -0,0 +1,71 @@
+#ifndef RD_CPP_RDSNAPSHOT_H
+#define RD_CPP_RDSNAPSHOT_H
+
+#include "base/RdReactiveBase.h"
+#include "base/IRdSnapshotable.h"
+
+#include <functional>
+
+#include <rd_framework_export.h>
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4250)
+#endif
+
+namespace rd
+{
+/**
+ * \brief Writes the state of every \ref IRdSnapshotable entity bound in the subtree of [root] as one blob tagged with
+ * [serialization_hash]. Each entity's state is written under its RdId together with its length, so a counterpart
+ * generated from a model with the same hash can apply it, and entities unknown to it are skipped.
+ */
+void RD_FRAMEWORK_API write_snapshot(RdBindableBase const& root, int64_t serialization_hash, Buffer& buffer);
+
+/**
+ * \brief Same as \ref write_snapshot, calling [flush] after the state of each entity, see \ref IWire::send_fragmented.
+ */
+void RD_FRAMEWORK_API write_snapshot(
+	RdBindableBase const& root, int64_t serialization_hash, Buffer& buffer, std::function<void()> const& flush);
+
+/**
+ * \brief Applies a blob written by \ref write_snapshot to the entities bound in the subtree of [root], see \ref
+ * IRdSnapshotable::apply_snapshot.
+ * \return false if the blob was written for another [serialization_hash], nothing is applied then.
+ */
+bool RD_FRAMEWORK_API apply_snapshot(RdBindableBase const& root, int64_t serialization_hash, Buffer& buffer);
+
+/**
+ * \brief Extension of \ref RdExtBase which delivers a snapshot of the whole ext to the counterpart in one message and
+ * applies the ones received. A counterpart without it drops the message as one for an unknown id.
+ */
+class RD_FRAMEWORK_API RdSnapshot final : public RdReactiveBase
+{
+public:
+	// region ctor/dtor
+
+	RdSnapshot() = default;
+
+	RdSnapshot(RdSnapshot&&) = default;
+
+	RdSnapshot& operator=(RdSnapshot&&) = default;
+
+	virtual ~RdSnapshot() = default;
+	// endregion
+
+	void init(Lifetime lifetime) const override;
+
+	/**
+	 * \brief Sends the state of the ext this is bound to, fragmented between entities where the wire supports it.
+	 */
+	void send() const;
+
+	void on_wire_received(Buffer buffer) const override;
+};
+}	 // namespace rd
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_RDSNAPSHOT_H
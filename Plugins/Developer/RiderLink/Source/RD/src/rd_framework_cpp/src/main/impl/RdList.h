@@ -3,6 +3,7 @@
 
 #include "reactive/ViewableList.h"
 #include "base/RdReactiveBase.h"
+#include "base/IRdSnapshotable.h"
 #include "serialization/Polymorphic.h"
 #include "std/allocator.h"
 
@@ -21,7 +22,7 @@ namespace rd
  * \tparam A allocator for values
  */
 template <typename T, typename S = Polymorphic<T>, typename A = allocator<T>>
-class RdList final : public RdReactiveBase, public ViewableList<T, A>, public ISerializable
+class RdList final : public RdReactiveBase, public ViewableList<T, A>, public ISerializable, public IRdSnapshotable
 {
 private:
 	using WT = typename IViewableList<T>::WT;
@@ -93,6 +94,10 @@ public:
 					}
 				}
 
+				// header, index and value
+				T const* sent_value = e.get_new_value();
+				const size_t size_hint = sizeof(int64_t) + sizeof(int32_t) +
+										 (sent_value ? estimate_serialized_size<S>(this->get_serialization_context(), *sent_value) : 0);
 				get_wire()->send(rdid, [this, e](Buffer& buffer) {
 					Op op = static_cast<Op>(e.v.index());
 
@@ -105,7 +110,7 @@ public:
 						S::write(this->get_serialization_context(), buffer, *new_value);
 					}
 					spdlog::get("logSend")->trace(logmsg(op, next_version - 1, e.get_index(), new_value));
-				});
+				}, size_hint);
 			});
 		});
 
@@ -164,6 +169,51 @@ public:
 		}
 	}
 
+	void write_snapshot(Buffer& buffer) const override
+	{
+		buffer.write_integral<int64_t>(next_version);
+		buffer.write_integral<int32_t>(static_cast<int32_t>(list::size()));
+		for (auto const& value : list::getList())
+		{
+			S::write(this->get_serialization_context(), buffer, wrapper::get<T>(value));
+		}
+	}
+
+	void apply_snapshot(Buffer& buffer) const override
+	{
+		const int64_t version = buffer.read_integral<int64_t>();
+		const int32_t count = buffer.read_integral<int32_t>();
+		RD_ASSERT_THROW_MSG(count >= 0, "list snapshot of negative size: " + std::to_string(count));
+		// read before the list is touched, so a malformed snapshot leaves it intact
+		std::vector<WT> values;
+		values.reserve((std::min)(static_cast<size_t>(count), buffer.get_remaining()));
+		for (int32_t i = 0; i < count; ++i)
+		{
+			values.push_back(S::read(this->get_serialization_context(), buffer));
+		}
+
+		next_version = version;
+		// elements are replaced in place, so only the difference in length is added or removed
+		while (list::size() > values.size())
+		{
+			list::removeAt(list::size() - 1);
+		}
+		for (size_t index = 0; index < values.size(); ++index)
+		{
+			auto& value = values[index];
+			if (index < list::size())
+			{
+				list::set(index, std::move(value));
+			}
+			else
+			{
+				list::add(std::move(value));
+			}
+		}
+		spdlog::get("logReceived")->trace("RECV list {} {}:: snapshot of {} elements, version = {}", to_string(location),
+			to_string(rdid), count, next_version);
+	}
+
 	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override
 	{
 		if (is_bound())
@@ -3,10 +3,12 @@
 
 #include "reactive/ViewableMap.h"
 #include "base/RdReactiveBase.h"
+#include "base/IRdSnapshotable.h"
 #include "serialization/Polymorphic.h"
-#include "util/shared_function.h"
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -27,7 +29,7 @@ namespace rd
  */
 template <typename K, typename V, typename KS = Polymorphic<K>, typename VS = Polymorphic<V>, typename KA = std::allocator<K>,
 	typename VA = std::allocator<V>>
-class RdMap final : public RdReactiveBase, public ViewableMap<K, V, KA, VA>, public ISerializable
+class RdMap final : public RdReactiveBase, public ViewableMap<K, V, KA, VA>, public ISerializable, public IRdSnapshotable
 {
 private:
 	using WK = typename IViewableMap<K, V>::WK;
@@ -103,6 +105,10 @@ public:
 					identifyPolymorphic(*new_value, *identity, identity->next(rdid));
 				}
 
+				// header, version, key and value
+				const size_t size_hint = sizeof(int32_t) + sizeof(int64_t) +
+										 estimate_serialized_size<KS>(this->get_serialization_context(), *e.get_key()) +
+										 (new_value ? estimate_serialized_size<VS>(this->get_serialization_context(), *new_value) : 0);
 				get_wire()->send(rdid, [this, e](Buffer& buffer) {
 					int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
 					Op op = static_cast<Op>(e.v.index());
@@ -126,7 +132,7 @@ public:
 					}
 
 					spdlog::get("logSend")->trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
-				});
+				}, size_hint);
 			});
 		});
 
@@ -196,6 +202,7 @@ public:
 		else
 		{
 			Buffer serialized_key;
+			serialized_key.set_integral_encoding(buffer.get_integral_encoding());
 			KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
 
 			bool is_put = (op == Op::ADD || op == Op::UPDATE);
@@ -224,15 +231,15 @@ public:
 
 			if (msg_versioned)
 			{
-				auto writer =
-					util::make_shared_function([version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
-						innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
-						innerBuffer.write_integral<int64_t>(version);
-						// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
-						innerBuffer.write_byte_array_raw(serialized_key.getArray());
-						// logSend.trace(logmsg(Op::ACK, version, serialized_key));
-					});
-				get_wire()->send(rdid, std::move(writer));
+				// wires run the writer before send returns, so the key is captured by reference
+				get_wire()->send(rdid, [version, &serialized_key](Buffer& innerBuffer) {
+					innerBuffer.set_integral_encoding(serialized_key.get_integral_encoding());
+					innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
+					innerBuffer.write_integral<int64_t>(version);
+					// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
+					innerBuffer.write_byte_array_raw(serialized_key.getArray());
+					// logSend.trace(logmsg(Op::ACK, version, serialized_key));
+				});
 				if (is_master)
 				{
 					spdlog::get("logReceived")->error("Both ends are masters: {}", to_string(location));
@@ -241,6 +248,51 @@ public:
 		}
 	}
 
+	void write_snapshot(Buffer& buffer) const override
+	{
+		buffer.write_integral<int32_t>(static_cast<int32_t>(map::size()));
+		for (auto it = map::begin(); it != map::end(); ++it)
+		{
+			KS::write(this->get_serialization_context(), buffer, it.key());
+			VS::write(this->get_serialization_context(), buffer, it.value());
+		}
+	}
+
+	void apply_snapshot(Buffer& buffer) const override
+	{
+		const int32_t count = buffer.read_integral<int32_t>();
+		RD_ASSERT_THROW_MSG(count >= 0, "map snapshot of negative size: " + std::to_string(count));
+		std::vector<std::pair<WK, WV>> entries;
+		entries.reserve((std::min)(static_cast<size_t>(count), buffer.get_remaining()));
+		ordered_set<K const*, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> keys;
+		for (int32_t i = 0; i < count; ++i)
+		{
+			WK key = KS::read(this->get_serialization_context(), buffer);
+			WV value = VS::read(this->get_serialization_context(), buffer);
+			entries.emplace_back(std::move(key), std::move(value));
+			keys.insert(&wrapper::get<K>(entries.back().first));
+		}
+
+		// removing from the back keeps the keys collected before in place
+		std::vector<K const*> stale;
+		for (auto it = map::begin(); it != map::end(); ++it)
+		{
+			if (keys.count(&it.key()) == 0)
+			{
+				stale.push_back(&it.key());
+			}
+		}
+		for (auto it = stale.rbegin(); it != stale.rend(); ++it)
+		{
+			map::remove(**it);
+		}
+		for (auto& entry : entries)
+		{
+			map::set(std::move(entry.first), std::move(entry.second));
+		}
+		spdlog::get("logReceived")->trace("RECV map {} {}:: snapshot of {} entries", to_string(location), to_string(rdid), count);
+	}
+
 	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override
 	{
 		if (is_bound())
@@ -3,9 +3,12 @@
 
 #include "reactive/ViewableSet.h"
 #include "base/RdReactiveBase.h"
+#include "base/IRdSnapshotable.h"
 #include "serialization/Polymorphic.h"
 #include "std/allocator.h"
 
+#include <vector>
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4250)
@@ -20,7 +23,7 @@ namespace rd
  * \tparam S "SerDes" for values
  */
 template <typename T, typename S = Polymorphic<T>, typename A = allocator<T>>
-class RdSet final : public RdReactiveBase, public ViewableSet<T, A>, public ISerializable
+class RdSet final : public RdReactiveBase, public ViewableSet<T, A>, public ISerializable, public IRdSnapshotable
 {
 private:
 	using WT = typename IViewableSet<T>::WT;
@@ -69,12 +72,16 @@ public:
 				if (!is_local_change)
 					return;
 
-				get_wire()->send(rdid, [this, kind, &v](Buffer& buffer) {
-					buffer.write_enum<AddRemove>(kind);
-					S::write(this->get_serialization_context(), buffer, v);
+				get_wire()->send(
+					rdid,
+					[this, kind, &v](Buffer& buffer) {
+						buffer.write_enum<AddRemove>(kind);
+						S::write(this->get_serialization_context(), buffer, v);
 
-					spdlog::get("logSend")->trace("SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
-				});
+						spdlog::get("logSend")->trace(
+							"SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
+					},
+					sizeof(int32_t) + estimate_serialized_size<S>(this->get_serialization_context(), v));
 			});
 		});
 
@@ -101,6 +108,48 @@ public:
 		}
 	}
 
+	void write_snapshot(Buffer& buffer) const override
+	{
+		buffer.write_integral<int32_t>(static_cast<int32_t>(set::size()));
+		for (auto const& value : *this)
+		{
+			S::write(this->get_serialization_context(), buffer, value);
+		}
+	}
+
+	void apply_snapshot(Buffer& buffer) const override
+	{
+		const int32_t count = buffer.read_integral<int32_t>();
+		RD_ASSERT_THROW_MSG(count >= 0, "set snapshot of negative size: " + std::to_string(count));
+		std::vector<WT> values;
+		values.reserve((std::min)(static_cast<size_t>(count), buffer.get_remaining()));
+		ordered_set<T const*, wrapper::TransparentHash<T>, wrapper::TransparentKeyEqual<T>> kept;
+		for (int32_t i = 0; i < count; ++i)
+		{
+			values.push_back(S::read(this->get_serialization_context(), buffer));
+			kept.insert(&wrapper::get<T>(values.back()));
+		}
+
+		// removing from the back keeps the values collected before in place
+		std::vector<T const*> stale;
+		for (auto const& value : *this)
+		{
+			if (kept.count(&value) == 0)
+			{
+				stale.push_back(&value);
+			}
+		}
+		for (auto it = stale.rbegin(); it != stale.rend(); ++it)
+		{
+			set::remove(**it);
+		}
+		for (auto& value : values)
+		{
+			set::add(std::move(value));
+		}
+		spdlog::get("logReceived")->trace("RECV set {} {}:: snapshot of {} values", to_string(location), to_string(rdid), count);
+	}
+
 	bool add(WT value) const override
 	{
 		return local_change([this, value = std::move(value)]() mutable { return set::add(std::move(value)); });
@@ -2,11 +2,16 @@
 
 #include "protocol/Buffer.h"
 
+#include "util/utf16.h"
+
 #include <string>
 #include <algorithm>
+#include <cstring>
 
 namespace rd
 {
+constexpr size_t Buffer::MAX_VARINT_LENGTH;
+
 Buffer::Buffer() : Buffer(16)
 {
 }
@@ -19,6 +24,26 @@ Buffer::Buffer(ByteArray array, size_t offset) : data_(std::move(array)), offset
 {
 }
 
+Buffer::Buffer(SharedChunk const& chunk, size_t from, size_t size)
+	: view_owner(chunk.get_storage()), view_data(chunk.data() + from), view_size(size)
+{
+}
+
+bool Buffer::is_view() const
+{
+	return view_owner != nullptr;
+}
+
+void Buffer::detach()
+{
+	if (!is_view())
+		return;
+	data_.assign(view_data, view_data + view_size);
+	view_owner.reset();
+	view_data = nullptr;
+	view_size = 0;
+}
+
 size_t Buffer::get_position() const
 {
 	return offset;
@@ -29,6 +54,11 @@ void Buffer::set_position(size_t value)
 	offset = value;
 }
 
+size_t Buffer::get_remaining() const
+{
+	return size() - offset;
+}
+
 void Buffer::check_available(size_t moreSize) const
 {
 	if (offset + moreSize > size())
@@ -43,7 +73,8 @@ void Buffer::read(word_t* dst, size_t size)
 	if (size == 0)
 		return;
 	check_available(size);
-	std::copy(&data_[offset], &data_[offset] + size, dst);
+	word_t const* src = static_cast<Buffer const&>(*this).data() + offset;
+	std::copy(src, src + size, dst);
 	offset += size;
 }
 
@@ -58,6 +89,7 @@ void Buffer::write(const word_t* src, size_t size)
 
 void Buffer::require_available(size_t moreSize)
 {
+	detach();
 	if (offset + moreSize >= size())
 	{
 		const size_t new_size = (std::max)(size() * 2, offset + moreSize);
@@ -70,13 +102,66 @@ void Buffer::rewind()
 	set_position(0);
 }
 
+Buffer::IntegralEncoding Buffer::get_integral_encoding() const
+{
+	return integral_encoding;
+}
+
+void Buffer::set_integral_encoding(IntegralEncoding value)
+{
+	integral_encoding = value;
+}
+
+uint64_t Buffer::read_varint()
+{
+	word_t const* src = static_cast<Buffer const&>(*this).data() + offset;
+	const size_t available = size() - offset;
+	uint64_t result = 0;
+	for (size_t i = 0; i < MAX_VARINT_LENGTH - 1; ++i)
+	{
+		if (i == available)
+		{
+			check_available(i + 1);
+		}
+		const word_t byte = src[i];
+		result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+		if ((byte & 0x80) == 0)
+		{
+			offset += i + 1;
+			return result;
+		}
+	}
+	check_available(MAX_VARINT_LENGTH);
+	result |= static_cast<uint64_t>(src[MAX_VARINT_LENGTH - 1]) << (7 * (MAX_VARINT_LENGTH - 1));
+	offset += MAX_VARINT_LENGTH;
+	return result;
+}
+
+void Buffer::write_varint(uint64_t value)
+{
+	word_t bytes[MAX_VARINT_LENGTH];
+	size_t length = 0;
+	while (value >= 0x80 && length < MAX_VARINT_LENGTH - 1)
+	{
+		bytes[length++] = static_cast<word_t>(value | 0x80);
+		value >>= 7;
+	}
+	bytes[length++] = static_cast<word_t>(value);
+	write(bytes, length);
+}
+
 Buffer::ByteArray Buffer::getArray() const&
 {
+	if (is_view())
+	{
+		return ByteArray(view_data, view_data + view_size);
+	}
 	return data_;
 }
 
 Buffer::ByteArray Buffer::getArray() &&
 {
+	detach();
 	rewind();
 	return std::move(data_);
 }
@@ -90,6 +175,7 @@ Buffer::ByteArray Buffer::getRealArray() const&
 
 Buffer::ByteArray Buffer::getRealArray() &&
 {
+	detach();
 	auto res = std::move(data_);
 	res.resize(offset);
 	rewind();
@@ -98,11 +184,12 @@ Buffer::ByteArray Buffer::getRealArray() &&
 
 Buffer::word_t const* Buffer::data() const
 {
-	return data_.data();
+	return is_view() ? view_data : data_.data();
 }
 
 Buffer::word_t* Buffer::data()
 {
+	detach();
 	return data_.data();
 }
 
@@ -118,7 +205,7 @@ Buffer::word_t* Buffer::current_pointer()
 
 size_t Buffer::size() const
 {
-	return data_.size();
+	return is_view() ? view_size : data_.size();
 }
 
 /*std::string Buffer::readString() const {
@@ -131,17 +218,25 @@ std::vector<uint8_t> v(value.begin(), value.end());
 writeArray<uint8_t>(v);
 }*/
 
+// wchar_t holds UTF-32, strings are converted from and to UTF-16 in place without intermediate arrays
 template <int>
 std::wstring read_wstring_spec(Buffer& buffer)
 {
-	auto v = buffer.read_array<std::vector, uint16_t>();
-	return std::wstring(v.begin(), v.end());
+	const int32_t len = buffer.read_packed_integral<int32_t>();
+	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+	buffer.check_available(sizeof(uint16_t) * len);
+	std::wstring result;
+	result.resize(len);
+	Buffer::word_t const* src = static_cast<Buffer const&>(buffer).current_pointer();
+	result.resize(util::utf16_to_utf32(src, len, &result[0]));
+	buffer.offset += sizeof(uint16_t) * len;
+	return result;
 }
 
 template <>
 std::wstring read_wstring_spec<2>(Buffer& buffer)
 {
-	const int32_t len = buffer.read_integral<int32_t>();
+	const int32_t len = buffer.read_packed_integral<int32_t>();
 	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
 	std::wstring result;
 	result.resize(len);
@@ -157,14 +252,18 @@ std::wstring Buffer::read_wstring()
 template <int>
 void write_wstring_spec(Buffer& buffer, wstring_view value)
 {
-	const std::vector<uint16_t> v(value.begin(), value.end());
-	buffer.write_array<std::vector, uint16_t>(v);
+	wchar_t const* src = value.data();
+	const size_t len = util::utf16_length(src, value.size());
+	buffer.write_packed_integral<int32_t>(static_cast<int32_t>(len));
+	buffer.require_available(sizeof(uint16_t) * len);
+	util::utf32_to_utf16(src, value.size(), buffer.data_.data() + buffer.offset);
+	buffer.offset += sizeof(uint16_t) * len;
 }
 
 template <>
 void write_wstring_spec<2>(Buffer& buffer, wstring_view value)
 {
-	buffer.write_integral<int32_t>(static_cast<int32_t>(value.size()));
+	buffer.write_packed_integral<int32_t>(static_cast<int32_t>(value.size()));
 	buffer.write(reinterpret_cast<Buffer::word_t const*>(value.data()), sizeof(wchar_t) * value.size());
 }
 
@@ -175,20 +274,29 @@ void Buffer::write_wstring(std::wstring const& value)
 
 void Buffer::write_char16_string(const uint16_t* data, size_t len)
 {
-	write_integral<int32_t>(static_cast<int32_t>(len));
+	write_packed_integral<int32_t>(static_cast<int32_t>(len));
 	write(reinterpret_cast<word_t const*>(data), sizeof(uint16_t) * len);
 }
 
 uint16_t* Buffer::read_char16_string()
-{	
-	const int32_t len = read_integral<int32_t>();
-	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
-	uint16_t * result = new uint16_t[len+1];
-	read(reinterpret_cast<Buffer::word_t*>(&result[0]), sizeof(uint16_t) * len);
-	result[len] = 0;
+{
+	const u16string_view view = read_char16_view();
+	uint16_t* result = new uint16_t[view.size() + 1];
+	memcpy(result, view.data(), sizeof(uint16_t) * view.size());
+	result[view.size()] = 0;
 	return result;
 }
 
+u16string_view Buffer::read_char16_view()
+{
+	const int32_t len = read_packed_integral<int32_t>();
+	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+	check_available(sizeof(uint16_t) * len);
+	char16_t const* result = reinterpret_cast<char16_t const*>(static_cast<Buffer const&>(*this).current_pointer());
+	offset += sizeof(uint16_t) * len;
+	return u16string_view(result, len);
+}
+
 void Buffer::write_wstring(wstring_view value)
 {
 	write_wstring_spec<sizeof(wchar_t)>(*this, value);
@@ -256,6 +364,7 @@ void Buffer::write_byte_array_raw(const ByteArray& array)
 
 Buffer::ByteArray& Buffer::get_data()
 {
+	detach();
 	return data_;
 }
 }	 // namespace rd
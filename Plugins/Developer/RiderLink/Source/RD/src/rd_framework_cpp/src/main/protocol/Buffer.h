@@ -11,6 +11,8 @@
 #include "types/wrapper.h"
 #include "std/allocator.h"
 #include "std/list.h"
+#include "protocol/SharedChunk.h"
+#include "util/fixed_layout.h"
 
 #include <vector>
 #include <type_traits>
@@ -35,6 +37,26 @@ public:
 
 	using ByteArray = std::vector<word_t, Allocator>;
 
+	/**
+	 * \brief How ids, lengths and integral values are written, see \ref write_packed_integral.
+	 */
+	enum class IntegralEncoding : uint8_t
+	{
+		/**
+		 * \brief Little-endian of the type's width, understood by every counterpart.
+		 */
+		Fixed,
+		/**
+		 * \brief LEB128, zigzag for signed types. Only used once the counterpart announced it reads it.
+		 */
+		Compact
+	};
+
+	/**
+	 * \brief LEB128 of a 64-bit value takes at most this many bytes, the last one holds 8 bits instead of 7.
+	 */
+	static constexpr size_t MAX_VARINT_LENGTH = 9;
+
 private:
 	template <int>
 	friend std::wstring read_wstring_spec(Buffer&);
@@ -46,6 +68,18 @@ private:
 
 	size_t offset = 0;
 
+	// read-only view over a slab shared with other buffers, see Buffer(SharedChunk const&, size_t, size_t)
+	std::shared_ptr<ByteArray const> view_owner;
+	word_t const* view_data = nullptr;
+	size_t view_size = 0;
+
+	IntegralEncoding integral_encoding = IntegralEncoding::Fixed;
+
+	bool is_view() const;
+
+	// copies viewed bytes into own storage, so the buffer can be modified
+	void detach();
+
 	// read
 	void read(word_t* dst, size_t size);
 
@@ -54,6 +88,35 @@ private:
 
 	size_t size() const;
 
+	uint64_t read_varint();
+
+	void write_varint(uint64_t value);
+
+	template <typename T>
+	static typename std::enable_if_t<std::is_signed<T>::value, uint64_t> zigzag(T value)
+	{
+		const int64_t x = value;
+		return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+	}
+
+	template <typename T>
+	static typename std::enable_if_t<!std::is_signed<T>::value, uint64_t> zigzag(T value)
+	{
+		return value;
+	}
+
+	template <typename T>
+	static typename std::enable_if_t<std::is_signed<T>::value, T> unzigzag(uint64_t value)
+	{
+		return static_cast<T>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+	}
+
+	template <typename T>
+	static typename std::enable_if_t<!std::is_signed<T>::value, T> unzigzag(uint64_t value)
+	{
+		return static_cast<T>(value);
+	}
+
 public:
 	// region ctor/dtor
 
@@ -63,6 +126,12 @@ public:
 
 	explicit Buffer(ByteArray array, size_t offset = 0);
 
+	/**
+	 * \brief Creates a read-only view over [size] bytes of [chunk] starting at [from] without copying them.
+	 * The view shares ownership of the chunk's storage. Any modification makes the buffer copy the bytes first.
+	 */
+	Buffer(SharedChunk const& chunk, size_t from, size_t size);
+
 	Buffer(Buffer const&) = delete;
 
 	Buffer& operator=(Buffer const&) = delete;
@@ -77,12 +146,25 @@ public:
 
 	void set_position(size_t value);
 
+	/**
+	 * \brief Number of bytes between the position and the end of the buffer.
+	 */
+	size_t get_remaining() const;
+
 	void require_available(size_t size);
 
 	void check_available(size_t moreSize) const;
 
 	void rewind();
 
+	IntegralEncoding get_integral_encoding() const;
+
+	/**
+	 * \brief Switches the encoding of the following \ref write_packed_integral and \ref read_packed_integral calls.
+	 * Wires set it on every message they send and receive, writers may reset it to Fixed for bytes serialized beforehand.
+	 */
+	void set_integral_encoding(IntegralEncoding value);
+
 	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
 	T read_integral()
 	{
@@ -97,6 +179,55 @@ public:
 		write(reinterpret_cast<word_t const*>(&value), sizeof(T));
 	}
 
+	/**
+	 * \brief Reads an integral written by \ref write_var_integral.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
+	T read_var_integral()
+	{
+		return unzigzag<T>(read_varint());
+	}
+
+	/**
+	 * \brief Writes [value] as LEB128 regardless of the buffer's encoding, signed values are zigzag-encoded first,
+	 * so that small negative numbers are short too.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	void write_var_integral(T const& value)
+	{
+		write_varint(zigzag(value));
+	}
+
+	/**
+	 * \brief Reads an integral written by \ref write_packed_integral in the same encoding.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
+	T read_packed_integral()
+	{
+		if (sizeof(T) > 1 && integral_encoding == IntegralEncoding::Compact)
+		{
+			return read_var_integral<T>();
+		}
+		return read_integral<T>();
+	}
+
+	/**
+	 * \brief Writes [value] according to the buffer's \ref IntegralEncoding. Used for ids, lengths and integral values
+	 * which are mostly small, single bytes are always written as is.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	void write_packed_integral(T const& value)
+	{
+		if (sizeof(T) > 1 && integral_encoding == IntegralEncoding::Compact)
+		{
+			write_var_integral<T>(value);
+		}
+		else
+		{
+			write_integral<T>(value);
+		}
+	}
+
 	template <typename T, typename = typename std::enable_if_t<std::is_floating_point<T>::value, T>>
 	T read_floating_point()
 	{
@@ -115,7 +246,7 @@ public:
 		typename = typename std::enable_if_t<util::is_pod_v<T>>>
 	C<T, A> read_array()
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_packed_integral<int32_t>();
 		RD_ASSERT_MSG(len >= 0, "read null array(length = " + std::to_string(len) + ")");
 		C<T, A> result;
 		using rd::resize;
@@ -127,10 +258,14 @@ public:
 		return result;
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>>
-	C<value_or_wrapper<T>, A> read_array(std::function<value_or_wrapper<T>()> reader)
+	/**
+	 * \brief Reads an array of elements read by [reader], any callable returning value_or_wrapper<T>.
+	 * A lambda is called directly and can be inlined, unlike a std::function.
+	 */
+	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>, typename F>
+	C<value_or_wrapper<T>, A> read_array(F&& reader)
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_packed_integral<int32_t>();
 		C<value_or_wrapper<T>, A> result;
 		using rd::resize;
 		resize(result, len);
@@ -141,42 +276,89 @@ public:
 		return result;
 	}
 
+	/**
+	 * \brief Reads an array written by \ref write_fixed_layout_array, the same bytes as the generated read of each
+	 * element. The whole array is checked once and every element is built right from its bytes.
+	 */
+	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>,
+		typename = typename std::enable_if_t<util::is_fixed_layout_v<T>>>
+	C<Wrapper<T>, A> read_fixed_layout_array()
+	{
+		constexpr size_t object_size = util::fixed_layout_size_v<T>;
+		int32_t len = read_packed_integral<int32_t>();
+		RD_ASSERT_MSG(len >= 0, "read null array(length = " + std::to_string(len) + ")");
+		check_available(object_size * len);
+		C<Wrapper<T>, A> result;
+		using rd::resize;
+		resize(result, len);
+		word_t const* src = static_cast<Buffer const&>(*this).data() + offset;
+		for (int32_t i = 0; i < len; ++i, src += object_size)
+		{
+			result[i] = util::load_fixed_layout<T>(
+				src, [](auto&&... fields) { return wrapper::make_wrapper<T>(std::forward<decltype(fields)>(fields)...); });
+		}
+		offset += object_size * len;
+		return result;
+	}
+
 	template <template <class, class> class C, typename T, typename A = allocator<T>,
 		typename = typename std::enable_if_t<util::is_pod_v<T>>>
 	void write_array(C<T, A> const& container)
 	{
 		using rd::size;
 		const int32_t& len = rd::size(container);
-		write_integral<int32_t>(static_cast<int32_t>(len));
+		write_packed_integral<int32_t>(static_cast<int32_t>(len));
 		if (len > 0)
 		{
 			write(reinterpret_cast<word_t const*>(&container[0]), sizeof(T) * len);
 		}
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<T>,
+	template <template <class, class> class C, typename T, typename A = allocator<T>, typename F,
 		typename = typename std::enable_if_t<!rd::util::in_heap_v<T>>>
-	void write_array(C<T, A> const& container, std::function<void(T const&)> writer)
+	void write_array(C<T, A> const& container, F&& writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_packed_integral<int32_t>(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(e);
 		}
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>>
-	void write_array(C<Wrapper<T>, A> const& container, std::function<void(T const&)> writer)
+	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>, typename F>
+	void write_array(C<Wrapper<T>, A> const& container, F&& writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_packed_integral<int32_t>(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(*e);
 		}
 	}
 
+	/**
+	 * \brief Writes an array of [T] as the generated write of each element does, in one reserved block. Only for
+	 * arrays whose elements are exactly [T] and written monomorphically, a subclass would be cut to the fields of [T].
+	 */
+	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>,
+		typename = typename std::enable_if_t<util::is_fixed_layout_v<T>>>
+	void write_fixed_layout_array(C<Wrapper<T>, A> const& container)
+	{
+		constexpr size_t object_size = util::fixed_layout_size_v<T>;
+		using rd::size;
+		const int32_t len = static_cast<int32_t>(size(container));
+		write_packed_integral<int32_t>(len);
+		require_available(object_size * len);
+		word_t* dst = data_.data() + offset;
+		for (auto const& e : container)
+		{
+			util::store_fixed_layout(*e, dst);
+			dst += object_size;
+		}
+		offset += object_size * len;
+	}
+
 	void read_byte_array(ByteArray& array);
 
 	void read_byte_array_raw(ByteArray& array);
@@ -197,8 +379,17 @@ public:
 
 	void write_char16_string(const uint16_t* data, size_t len);
 
+	/**
+	 * \brief Reads a string written by \ref write_char16_string into a new null-terminated array, free it with delete[].
+	 */
 	uint16_t * read_char16_string();
 
+	/**
+	 * \brief Reads a string written by \ref write_char16_string without copying it. The view points into the buffer,
+	 * so it's valid until the buffer is modified or destroyed, and it may be unaligned.
+	 */
+	u16string_view read_char16_view();
+
 	std::wstring read_wstring();
 
 	void write_wstring(std::wstring const& value);
@@ -260,9 +451,8 @@ public:
 		return reader();
 	}
 
-	template <typename T>
-	typename std::enable_if_t<!std::is_abstract<T>::value> write_nullable(
-		optional<T> const& value, std::function<void(T const&)> writer)
+	template <typename T, typename F>
+	typename std::enable_if_t<!std::is_abstract<T>::value> write_nullable(optional<T> const& value, F&& writer)
 	{
 		if (!value)
 		{
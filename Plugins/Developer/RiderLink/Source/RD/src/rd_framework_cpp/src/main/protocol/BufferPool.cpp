@@ -0,0 +1,95 @@
+#include "BufferPool.h"
+
+#include <algorithm>
+
+namespace rd
+{
+constexpr size_t BufferPool::MIN_CLASS_BITS;
+constexpr size_t BufferPool::CLASSES;
+constexpr size_t BufferPool::MAX_POOLED_SIZE;
+constexpr size_t BufferPool::MAX_BYTES_PER_CLASS;
+constexpr size_t BufferPool::MAX_ARRAYS_PER_CLASS;
+constexpr size_t BufferPool::DEFAULT_SIZE;
+
+size_t BufferPool::class_size(size_t index)
+{
+	return size_t(1) << (MIN_CLASS_BITS + index);
+}
+
+Buffer::ByteArray BufferPool::acquire(size_t size)
+{
+	if (size > MAX_POOLED_SIZE)
+	{
+		misses.fetch_add(1, std::memory_order_relaxed);
+		return Buffer::ByteArray(size);
+	}
+
+	// the smallest class which fits [size]
+	size_t index = 0;
+	while (class_size(index) < size)
+	{
+		++index;
+	}
+
+	Buffer::ByteArray result;
+	{
+		SizeClass& size_class = classes[index];
+		std::lock_guard<decltype(size_class.lock)> guard(size_class.lock);
+		if (!size_class.arrays.empty())
+		{
+			result = std::move(size_class.arrays.back());
+			size_class.arrays.pop_back();
+		}
+	}
+	if (result.capacity() == 0)
+	{
+		misses.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		hits.fetch_add(1, std::memory_order_relaxed);
+	}
+	// capacity of a pooled array is at least the class size, so this never reallocates
+	result.resize(class_size(index));
+	return result;
+}
+
+void BufferPool::release(Buffer::ByteArray array)
+{
+	const size_t capacity = array.capacity();
+	if (capacity < class_size(0) || capacity >= 2 * MAX_POOLED_SIZE)
+	{
+		return;
+	}
+
+	// the largest class which [capacity] covers
+	size_t index = CLASSES - 1;
+	while (class_size(index) > capacity)
+	{
+		--index;
+	}
+
+	array.clear();
+	SizeClass& size_class = classes[index];
+	std::lock_guard<decltype(size_class.lock)> guard(size_class.lock);
+	const size_t limit = (std::min)(MAX_ARRAYS_PER_CLASS, MAX_BYTES_PER_CLASS / class_size(index));
+	if (size_class.arrays.size() < limit)
+	{
+		size_class.arrays.push_back(std::move(array));
+	}
+}
+
+BufferPool::Stats BufferPool::get_stats() const
+{
+	Stats stats;
+	stats.hits = hits.load(std::memory_order_relaxed);
+	stats.misses = misses.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < CLASSES; ++i)
+	{
+		std::lock_guard<decltype(classes[i].lock)> guard(classes[i].lock);
+		stats.pooled_arrays += classes[i].arrays.size();
+		stats.pooled_bytes += classes[i].arrays.size() * class_size(i);
+	}
+	return stats;
+}
+}	 // namespace rd
@@ -0,0 +1,105 @@
+#ifndef RD_CPP_BUFFERPOOL_H
+#define RD_CPP_BUFFERPOOL_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/Buffer.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Size-classed free lists of byte arrays for outgoing packages. Wires acquire arrays to serialize messages into
+ * and the retransmit window gives them back once the counterpart acknowledged them, so steady traffic is served
+ * without touching the heap.
+ */
+class RD_FRAMEWORK_API BufferPool
+{
+public:
+	/**
+	 * \brief Smallest size class is 2^MIN_CLASS_BITS bytes, every next one is twice as large.
+	 */
+	static constexpr size_t MIN_CLASS_BITS = 6;
+	static constexpr size_t CLASSES = 11;
+	static constexpr size_t MAX_POOLED_SIZE = size_t(1) << (MIN_CLASS_BITS + CLASSES - 1);
+	/**
+	 * \brief Every class retains at most this many bytes (and at most MAX_ARRAYS_PER_CLASS arrays).
+	 */
+	static constexpr size_t MAX_BYTES_PER_CLASS = size_t(1) << 19;
+	static constexpr size_t MAX_ARRAYS_PER_CLASS = 1024;
+	/**
+	 * \brief Size acquired when the writer gave no hint, large enough for most of the messages.
+	 */
+	static constexpr size_t DEFAULT_SIZE = 256;
+
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t pooled_arrays = 0;
+		size_t pooled_bytes = 0;
+	};
+
+private:
+	struct SizeClass
+	{
+		mutable std::mutex lock;
+		std::vector<Buffer::ByteArray> arrays;
+	};
+
+	std::array<SizeClass, CLASSES> classes;
+
+	std::atomic<uint64_t> hits{0};
+	std::atomic<uint64_t> misses{0};
+
+	static size_t class_size(size_t index);
+
+public:
+	// region ctor/dtor
+
+	BufferPool() = default;
+
+	BufferPool(BufferPool const&) = delete;
+
+	BufferPool& operator=(BufferPool const&) = delete;
+	// endregion
+
+	/**
+	 * \brief Returns an array of at least [size] bytes. Its size is rounded up to the size class, so
+	 * a Buffer created over it doesn't have to grow while less than that is written.
+	 */
+	Buffer::ByteArray acquire(size_t size = DEFAULT_SIZE);
+
+	/**
+	 * \brief Gives [array] back for reuse. Its content is discarded and its capacity is kept. Arrays too small or too
+	 * large for any class, and arrays over the class budget, are simply freed.
+	 */
+	void release(Buffer::ByteArray array);
+
+	Stats get_stats() const;
+
+	/**
+	 * \brief global pool for whole application.
+	 */
+	static BufferPool& Instance()
+	{
+		static BufferPool globalBufferPool;
+		return globalBufferPool;
+	}
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_BUFFERPOOL_H
@@ -8,12 +8,45 @@ namespace rd
 std::shared_ptr<spdlog::logger> MessageBroker::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logger", spdlog::color_mode::automatic);
 
+constexpr size_t MessageBroker::SHARD_COUNT;
+
 static void execute(const IRdReactive* that, Buffer msg)
 {
 	msg.read_integral<int16_t>();	   // skip context
 	that->on_wire_received(std::move(msg));
 }
 
+MessageBroker::Shard& MessageBroker::shard_of(RdId const& id) const
+{
+	// ids are hashes of names, except for small static ones, so folding the halves is enough
+	const uint64_t hash = static_cast<uint64_t>(id.get_hash());
+	return shards[static_cast<size_t>(hash ^ (hash >> 32)) % SHARD_COUNT];
+}
+
+RdReactiveBase const* MessageBroker::find_subscription(Shard const& shard, RdId const& id)
+{
+	auto it = shard.subscriptions.find(id);
+	return it == shard.subscriptions.end() ? nullptr : it->second;
+}
+
+void MessageBroker::execute_if_subscribed(const RdReactiveBase* that, Buffer msg) const
+{
+	bool exists_id = false;
+	{
+		Shard& shard = shard_of(that->get_id());
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		exists_id = find_subscription(shard, that->get_id()) != nullptr;
+	}
+	if (exists_id)
+	{
+		execute(that, std::move(msg));
+	}
+	else
+	{
+		logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(that->get_id()));
+	}
+}
+
 void MessageBroker::invoke(const RdReactiveBase* that, Buffer msg, bool sync) const
 {
 	if (sync)
@@ -22,23 +55,20 @@ void MessageBroker::invoke(const RdReactiveBase* that, Buffer msg, bool sync) co
 	}
 	else
 	{
-		auto action = [this, that, message = std::move(msg)]() mutable {
-			bool exists_id = false;
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				exists_id = subscriptions.count(that->get_id()) > 0;
-			}
-			if (exists_id)
-			{
-				execute(that, std::move(message));
-			}
-			else
-			{
-				logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(that->get_id()));
-			}
-		};
-		std::function<void()> function = util::make_shared_function(std::move(action));
-		that->get_wire_scheduler()->queue(std::move(function));
+		that->get_wire_scheduler()->queue(
+			[this, that, message = std::move(msg)]() mutable { execute_if_subscribed(that, std::move(message)); });
+	}
+}
+
+void MessageBroker::invoke_or_batch(const RdReactiveBase* that, Buffer msg) const
+{
+	if (batching && that->get_wire_scheduler() == default_scheduler)
+	{
+		batch.push_back(BatchEntry{that, that->get_id(), make_optional<Buffer>(std::move(msg))});
+	}
+	else
+	{
+		invoke(that, std::move(msg));
 	}
 }
 
@@ -46,75 +76,90 @@ MessageBroker::MessageBroker(IScheduler* defaultScheduler) : default_scheduler(d
 {
 }
 
+void MessageBroker::dispatch_pending(RdId const& id) const
+{
+	Shard& shard = shard_of(id);
+
+	RdReactiveBase const* subscription = nullptr;
+	optional<Buffer> message;
+	{
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		subscription = find_subscription(shard, id);
+		auto it = shard.broker.find(id);
+		if (it != shard.broker.end() && !it->second.default_scheduler_messages.empty())
+		{
+			message = make_optional<Buffer>(std::move(it->second.default_scheduler_messages.front()));
+			it->second.default_scheduler_messages.pop();
+		}
+	}
+	if (subscription != nullptr)
+	{
+		if (message)
+		{
+			invoke(subscription, *std::move(message), subscription->get_wire_scheduler() == default_scheduler);
+		}
+	}
+	else
+	{
+		logger->trace("No handler for id: {}", to_string(id));
+	}
+
+	Mq drained;
+	{
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		// the handler may have run a nested dispatch, so the queue is looked up again
+		auto it = shard.broker.find(id);
+		if (it == shard.broker.end() || !it->second.default_scheduler_messages.empty())
+		{
+			return;
+		}
+		drained = std::move(it->second);
+		shard.broker.erase(it);
+	}
+	if (subscription == nullptr)
+	{
+		return;
+	}
+	for (auto& it : drained.custom_scheduler_messages)
+	{
+		RD_ASSERT_MSG(subscription->get_wire_scheduler() != default_scheduler, "require equals of wire and default schedulers")
+		invoke(subscription, std::move(it));
+	}
+}
+
 void MessageBroker::dispatch(RdId id, Buffer message) const
 {
 	RD_ASSERT_MSG(!id.isNull(), "id mustn't be null")
 
+	Shard& shard = shard_of(id);
 	{	 // synchronized recursively
-		std::lock_guard<decltype(lock)> guard(lock);
-		RdReactiveBase const* s = subscriptions[id];
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		RdReactiveBase const* s = find_subscription(shard, id);
 		if (s == nullptr)
 		{
-			auto it = broker.find(id);
-			if (it == broker.end())
+			shard.broker[id].default_scheduler_messages.emplace(std::move(message));
+
+			if (batching)
 			{
-				it = broker.emplace(id, Mq{}).first;
+				batch.push_back(BatchEntry{nullptr, id, nullopt});
+			}
+			else
+			{
+				default_scheduler->queue([this, id]() { dispatch_pending(id); });
 			}
-
-			broker[id].default_scheduler_messages.emplace(std::move(message));
-
-			auto action = [this, it, id]() mutable {
-				auto& current = it->second;
-				RdReactiveBase const* subscription = subscriptions[id];
-
-				optional<Buffer> message;
-				{
-					std::lock_guard<decltype(lock)> guard(lock);
-					if (!current.default_scheduler_messages.empty())
-					{
-						message = make_optional<Buffer>(std::move(current.default_scheduler_messages.front()));
-						current.default_scheduler_messages.pop();
-					}
-				}
-				if (subscription != nullptr)
-				{
-					if (message)
-					{
-						invoke(subscription, *std::move(message), subscription->get_wire_scheduler() == default_scheduler);
-					}
-				}
-				else
-				{
-					logger->trace("No handler for id: {}", to_string(id));
-				}
-
-				if (current.default_scheduler_messages.empty())
-				{
-					auto t = std::move(broker[id]);
-					broker.erase(id);
-					for (auto& it : t.custom_scheduler_messages)
-					{
-						RD_ASSERT_MSG(subscription->get_wire_scheduler() != default_scheduler,
-							"require equals of wire and default schedulers")
-						invoke(subscription, std::move(it));
-					}
-				}
-			};
-			std::function<void()> function = util::make_shared_function(std::move(action));
-			default_scheduler->queue(std::move(function));
 		}
 		else
 		{
 			if (s->get_wire_scheduler() == default_scheduler || s->get_wire_scheduler()->out_of_order_execution)
 			{
-				invoke(s, std::move(message));
+				invoke_or_batch(s, std::move(message));
 			}
 			else
 			{
-				auto it = broker.find(id);
-				if (it == broker.end())
+				auto it = shard.broker.find(id);
+				if (it == shard.broker.end())
 				{
-					invoke(s, std::move(message));
+					invoke_or_batch(s, std::move(message));
 				}
 				else
 				{
@@ -124,8 +169,46 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 			}
 		}
 	}
+}
+
+void MessageBroker::begin_batch() const
+{
+	batching = true;
+}
+
+void MessageBroker::end_batch() const
+{
+	batching = false;
+	if (batch.empty())
+	{
+		return;
+	}
+	std::vector<BatchEntry> entries = std::move(batch);
+	batch.clear();
+	default_scheduler->queue([this, entries = std::move(entries)]() mutable { execute_batch(entries); });
+}
 
-	//        }
+void MessageBroker::execute_batch(std::vector<BatchEntry>& entries) const
+{
+	for (auto& entry : entries)
+	{
+		// a failing handler must not take the rest of the package with it
+		try
+		{
+			if (entry.entity == nullptr)
+			{
+				dispatch_pending(entry.id);
+			}
+			else
+			{
+				execute_if_subscribed(entry.entity, *std::move(entry.message));
+			}
+		}
+		catch (std::exception const& e)
+		{
+			logger->error("Handler for id {} failed | {}", to_string(entry.id), e.what());
+		}
+	}
 }
 
 void MessageBroker::advise_on(Lifetime lifetime, RdReactiveBase const* entity) const
@@ -135,12 +218,16 @@ void MessageBroker::advise_on(Lifetime lifetime, RdReactiveBase const* entity) c
 	// advise MUST happen under default scheduler, not custom
 	default_scheduler->assert_thread();
 
-	std::lock_guard<decltype(lock)> guard(lock);
+	auto key = entity->get_id();
+	Shard& shard = shard_of(key);
+	std::lock_guard<decltype(shard.lock)> guard(shard.lock);
 	if (!lifetime->is_terminated())
 	{
-		auto key = entity->get_id();
-		subscriptions[key] = entity;
-		lifetime->add_action([this, key]() { subscriptions.erase(key); });
+		shard.subscriptions[key] = entity;
+		lifetime->add_action([&shard, key]() {
+			std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+			shard.subscriptions.erase(key);
+		});
 	}
 }
 }	 // namespace rd
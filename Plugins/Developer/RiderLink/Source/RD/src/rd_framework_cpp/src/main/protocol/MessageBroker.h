@@ -12,7 +12,10 @@
 
 #include "spdlog/spdlog.h"
 
+#include <array>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 #include <rd_framework_export.h>
 
@@ -43,16 +46,55 @@ public:
 class RD_FRAMEWORK_API MessageBroker final
 {
 private:
+	/**
+	 * \brief Subscriptions and messages waiting for them of the ids falling into one shard. A message only locks its
+	 * own shard, so receiver threads of several wires rarely wait for each other or for binding on the scheduler.
+	 */
+	struct Shard
+	{
+		rd::unordered_map<RdId, RdReactiveBase const*> subscriptions;
+		rd::unordered_map<RdId, Mq> broker;
+
+		std::recursive_mutex lock;
+	};
+
+	static constexpr size_t SHARD_COUNT = 16;
+
+	/**
+	 * \brief Message collected by a batch, executed by its entity or, without one, handed over to \ref dispatch_pending.
+	 */
+	struct BatchEntry
+	{
+		RdReactiveBase const* entity;
+		RdId id;
+		optional<Buffer> message;
+	};
+
 	IScheduler* default_scheduler = nullptr;
-	mutable rd::unordered_map<RdId, RdReactiveBase const*> subscriptions;
-	mutable rd::unordered_map<RdId, Mq> broker;
+	mutable std::array<Shard, SHARD_COUNT> shards;
 
-	mutable std::recursive_mutex lock;
+	// owned by the thread calling dispatch, see begin_batch. Handlers run on scheduler threads never look at them
+	mutable std::vector<BatchEntry> batch;
+	mutable bool batching = false;
 
 	static std::shared_ptr<spdlog::logger> logger;
 
+	Shard& shard_of(RdId const& id) const;
+
+	// never inserts, unknown ids don't grow the table
+	static RdReactiveBase const* find_subscription(Shard const& shard, RdId const& id);
+
+	void execute_if_subscribed(const RdReactiveBase* that, Buffer msg) const;
+
 	void invoke(const RdReactiveBase* that, Buffer msg, bool sync = false) const;
 
+	// invoke for the thread calling dispatch, which may add the message to the batch
+	void invoke_or_batch(const RdReactiveBase* that, Buffer msg) const;
+
+	void dispatch_pending(RdId const& id) const;
+
+	void execute_batch(std::vector<BatchEntry>& entries) const;
+
 public:
 	// region ctor/dtor
 
@@ -61,6 +103,41 @@ public:
 
 	void dispatch(RdId id, Buffer message) const;
 
+	/**
+	 * \brief Starts collecting the messages for the default scheduler instead of queueing each of them.
+	 * Only the thread calling \ref dispatch may batch, a wire does it for the messages of one package.
+	 */
+	void begin_batch() const;
+
+	/**
+	 * \brief Queues the messages collected since \ref begin_batch as a single action which executes them in order.
+	 */
+	void end_batch() const;
+
+	/**
+	 * \brief Begins a batch on construction and ends it on destruction, so a receiver leaving its loop
+	 * by an error or an exception doesn't leave the broker batching.
+	 */
+	class BatchGuard
+	{
+		MessageBroker const& broker;
+
+	public:
+		explicit BatchGuard(MessageBroker const& broker) : broker(broker)
+		{
+			broker.begin_batch();
+		}
+
+		BatchGuard(BatchGuard const&) = delete;
+
+		BatchGuard& operator=(BatchGuard const&) = delete;
+
+		~BatchGuard()
+		{
+			broker.end_batch();
+		}
+	};
+
 	void advise_on(Lifetime lifetime, RdReactiveBase const* entity) const;
 };
 }	 // namespace rd
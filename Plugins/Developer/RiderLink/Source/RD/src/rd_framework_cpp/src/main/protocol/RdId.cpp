@@ -6,13 +6,13 @@ namespace rd
 {
 RdId RdId::read(Buffer& buffer)
 {
-	const auto number = buffer.read_integral<hash_t>();
+	const auto number = buffer.read_packed_integral<hash_t>();
 	return RdId(number);
 }
 
 void RdId::write(Buffer& buffer) const
 {
-	buffer.write_integral(hash);
+	buffer.write_packed_integral(hash);
 }
 
 std::string to_string(RdId const& id)
@@ -70,6 +70,9 @@ public:
 
 	static RdId read(Buffer& buffer);
 
+	/**
+	 * \brief Written as a packed integral, so static ids take a few bytes in compact messages.
+	 */
 	void write(Buffer& buffer) const;
 
 	constexpr hash_t get_hash() const
@@ -0,0 +1,47 @@
+#include "SharedChunk.h"
+
+namespace rd
+{
+SharedChunk::SharedChunk(size_t size)
+{
+	reset(size);
+}
+
+void SharedChunk::reset(size_t size)
+{
+	if (storage == nullptr || is_shared())
+	{
+		storage = std::make_shared<storage_t>(size);
+	}
+	else if (storage->size() < size)
+	{
+		storage->resize(size);
+	}
+	size_ = size;
+}
+
+bool SharedChunk::is_shared() const
+{
+	return storage.use_count() > 1;
+}
+
+size_t SharedChunk::size() const
+{
+	return size_;
+}
+
+SharedChunk::word_t* SharedChunk::data()
+{
+	return storage ? storage->data() : nullptr;
+}
+
+SharedChunk::word_t const* SharedChunk::data() const
+{
+	return storage ? storage->data() : nullptr;
+}
+
+std::shared_ptr<SharedChunk::storage_t const> SharedChunk::get_storage() const
+{
+	return storage;
+}
+}	 // namespace rd
@@ -0,0 +1,64 @@
+#ifndef RD_CPP_SHAREDCHUNK_H
+#define RD_CPP_SHAREDCHUNK_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Reference-counted slab of bytes. Read-only views (see Buffer) may share ownership of the slab, so data
+ * received into it can be handed over to other threads without copying. Storage is recycled once no views are alive.
+ */
+class RD_FRAMEWORK_API SharedChunk
+{
+public:
+	using word_t = uint8_t;
+
+	using storage_t = std::vector<word_t>;
+
+private:
+	std::shared_ptr<storage_t> storage;
+
+	size_t size_ = 0;
+
+public:
+	// region ctor/dtor
+
+	SharedChunk() = default;
+
+	explicit SharedChunk(size_t size);
+
+	// endregion
+
+	/**
+	 * \brief Prepares the chunk to be filled with [size] new bytes. Current storage is reused if no views reference it,
+	 * otherwise it's left to the views and a fresh one is allocated.
+	 */
+	void reset(size_t size);
+
+	bool is_shared() const;
+
+	size_t size() const;
+
+	word_t* data();
+
+	word_t const* data() const;
+
+	std::shared_ptr<storage_t const> get_storage() const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_SHAREDCHUNK_H
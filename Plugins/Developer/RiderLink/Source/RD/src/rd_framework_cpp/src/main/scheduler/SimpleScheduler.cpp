@@ -6,7 +6,7 @@ void SimpleScheduler::flush()
 {
 }
 
-void SimpleScheduler::queue(std::function<void()> action)
+void SimpleScheduler::queue(util::unique_function<void()> action)
 {
 	action();
 }
@@ -2,17 +2,15 @@
 
 #include <utility>
 
-#include "ctpl_stl.h"
-
 namespace rd
 {
 SingleThreadScheduler::SingleThreadScheduler(Lifetime lifetime, std::string name)
 	: SingleThreadSchedulerBase(std::move(name)), lifetime(lifetime)
 {
-	lifetime->add_action([this]() {
+	termination_action = lifetime->add_action([this]() {
 		try
 		{
-			pool->stop(true);
+			stop();
 		}
 		catch (std::exception const& e)
 		{
@@ -21,4 +19,9 @@ SingleThreadScheduler::SingleThreadScheduler(Lifetime lifetime, std::string name
 		}
 	});
 }
+
+SingleThreadScheduler::~SingleThreadScheduler()
+{
+	lifetime->remove_action(termination_action);
+}
 }	 // namespace rd
\ No newline at end of file
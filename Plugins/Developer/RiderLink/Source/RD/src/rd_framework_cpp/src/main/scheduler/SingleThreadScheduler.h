@@ -11,10 +11,15 @@ namespace rd
 {
 class RD_FRAMEWORK_API SingleThreadScheduler : public SingleThreadSchedulerBase
 {
+	// removed by the destructor, the lifetime may outlive the scheduler
+	LifetimeImpl::counter_t termination_action = -1;
+
 public:
 	Lifetime lifetime;
 
 	SingleThreadScheduler(Lifetime lifetime, std::string name);
+
+	~SingleThreadScheduler() override;
 };
 }	 // namespace rd
 
@@ -0,0 +1,269 @@
+#include "TimerWheel.h"
+
+#include <util/thread_util.h>
+
+#include <limits>
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+namespace rd
+{
+std::shared_ptr<spdlog::logger> TimerWheel::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("timerWheelLog", spdlog::color_mode::automatic);
+
+constexpr std::chrono::milliseconds TimerWheel::TICK;
+constexpr size_t TimerWheel::SLOT_BITS;
+constexpr size_t TimerWheel::SLOTS;
+constexpr size_t TimerWheel::LEVELS;
+
+TimerWheel::TimerWheel()
+{
+	thread = std::thread([this] { run(); });
+}
+
+TimerWheel::~TimerWheel()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		stopped = true;
+	}
+	wakeup.notify_all();
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+uint64_t TimerWheel::tick_of(clock_t::time_point time) const
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time - start).count() / TICK.count());
+}
+
+void TimerWheel::place(timer_id_t id, uint64_t expiration)
+{
+	for (size_t level = 0; level < LEVELS; ++level)
+	{
+		const size_t shift = level * SLOT_BITS;
+		if ((expiration >> shift) - (current_tick >> shift) < SLOTS)
+		{
+			slots[level][(expiration >> shift) & (SLOTS - 1)].push_back(id);
+			++level_sizes[level];
+			return;
+		}
+	}
+	// beyond the horizon of the wheel, park in the farthest slot and place again once it's cascaded
+	const size_t shift = (LEVELS - 1) * SLOT_BITS;
+	slots[LEVELS - 1][((current_tick >> shift) + SLOTS - 1) & (SLOTS - 1)].push_back(id);
+	++level_sizes[LEVELS - 1];
+}
+
+void TimerWheel::cascade(size_t level)
+{
+	std::vector<timer_id_t> ids;
+	ids.swap(slots[level][(current_tick >> (level * SLOT_BITS)) & (SLOTS - 1)]);
+	level_sizes[level] -= ids.size();
+	for (timer_id_t id : ids)
+	{
+		auto it = timers.find(id);
+		if (it != timers.end())
+		{
+			place(id, it->second.expiration);
+		}
+	}
+}
+
+void TimerWheel::advance(uint64_t tick, std::vector<std::pair<timer_id_t, action_t>>& due)
+{
+	current_tick = tick;
+	// higher levels are cascaded first, so their timers may land in lower slots cascaded right after
+	for (size_t level = LEVELS - 1; level > 0; --level)
+	{
+		if ((tick & ((uint64_t(1) << (level * SLOT_BITS)) - 1)) == 0)
+		{
+			cascade(level);
+		}
+	}
+
+	std::vector<timer_id_t> ids;
+	ids.swap(slots[0][tick & (SLOTS - 1)]);
+	level_sizes[0] -= ids.size();
+	for (timer_id_t id : ids)
+	{
+		auto it = timers.find(id);
+		if (it == timers.end())
+		{
+			continue;
+		}
+		Timer& timer = it->second;
+		if (timer.expiration > tick)
+		{
+			place(id, timer.expiration);
+			continue;
+		}
+		due.emplace_back(id, timer.action);
+		if (timer.period > 0)
+		{
+			timer.expiration = tick + timer.period;
+			place(id, timer.expiration);
+		}
+	}
+}
+
+uint64_t TimerWheel::next_event_tick() const
+{
+	// a level-0 slot is due at its tick, a slot of a higher level is cascaded at the first tick of its range
+	uint64_t tick = (std::numeric_limits<uint64_t>::max)();
+	for (size_t level = 0; level < LEVELS; ++level)
+	{
+		if (level_sizes[level] == 0)
+		{
+			continue;
+		}
+		const size_t shift = level * SLOT_BITS;
+		for (uint64_t next = (current_tick >> shift) + 1; next <= (current_tick >> shift) + SLOTS; ++next)
+		{
+			if (!slots[level][next & (SLOTS - 1)].empty())
+			{
+				tick = (std::min)(tick, next << shift);
+				break;
+			}
+		}
+	}
+	return tick;
+}
+
+TimerWheel::clock_t::time_point TimerWheel::next_wakeup() const
+{
+	const uint64_t tick = next_event_tick();
+	if (tick == (std::numeric_limits<uint64_t>::max)())
+	{
+		return clock_t::time_point::max();
+	}
+	return start + TICK * tick;
+}
+
+void TimerWheel::run()
+{
+	rd::util::set_thread_name("TimerWheel");
+
+	std::unique_lock<decltype(lock)> guard(lock);
+	std::vector<std::pair<timer_id_t, action_t>> due;
+	while (!stopped)
+	{
+		const uint64_t now_tick = tick_of(clock_t::now());
+		// ticks without a due slot or a cascade are skipped, so catching up after a long sleep is cheap
+		while (current_tick < now_tick)
+		{
+			advance((std::min)(next_event_tick(), now_tick), due);
+		}
+
+		for (auto& item : due)
+		{
+			auto it = timers.find(item.first);
+			if (it == timers.end())
+			{
+				// cancelled meanwhile
+				continue;
+			}
+			const bool one_shot = it->second.period == 0;
+			running_id = item.first;
+			guard.unlock();
+			try
+			{
+				item.second();
+			}
+			catch (std::exception const& e)
+			{
+				logger->error("timer {} failed | {}", item.first, e.what());
+			}
+			guard.lock();
+			running_id = 0;
+			if (one_shot)
+			{
+				timers.erase(item.first);
+			}
+			finished.notify_all();
+		}
+		due.clear();
+
+		const auto deadline = next_wakeup();
+		if (deadline == clock_t::time_point::max())
+		{
+			wakeup.wait(guard);
+		}
+		else
+		{
+			wakeup.wait_until(guard, deadline);
+		}
+	}
+}
+
+TimerWheel::timer_id_t TimerWheel::schedule(std::chrono::milliseconds delay, action_t action, std::chrono::milliseconds period)
+{
+	const auto now = clock_t::now();
+	const auto ticks = [](std::chrono::milliseconds duration) {
+		return static_cast<uint64_t>((std::max)(decltype(TICK)::rep(0), (duration.count() + TICK.count() - 1) / TICK.count()));
+	};
+
+	timer_id_t id;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (timers.empty())
+		{
+			// nothing is pending, so the idle wheel may drop stale ids and skip the elapsed ticks at once
+			for (auto& level : slots)
+			{
+				for (auto& slot : level)
+				{
+					slot.clear();
+				}
+			}
+			level_sizes.fill(0);
+			current_tick = (std::max)(current_tick, tick_of(now));
+		}
+		id = next_id++;
+		// counted from the end of the current tick, so the action never runs before [delay] has passed
+		const uint64_t expiration = (std::max)(tick_of(now) + 1 + ticks(delay), current_tick + 1);
+		const uint64_t period_ticks = period.count() > 0 ? (std::max)(ticks(period), uint64_t(1)) : 0;
+		timers.emplace(id, Timer{expiration, period_ticks, std::move(action)});
+		place(id, expiration);
+	}
+	wakeup.notify_one();
+	return id;
+}
+
+void TimerWheel::schedule(Lifetime lifetime, std::chrono::milliseconds delay, action_t action, std::chrono::milliseconds period)
+{
+	if (lifetime->is_terminated())
+	{
+		return;
+	}
+	const timer_id_t id = schedule(delay, std::move(action), period);
+	try
+	{
+		lifetime->add_action([this, id] { cancel(id); });
+	}
+	catch (std::invalid_argument const&)
+	{
+		// terminated concurrently
+		cancel(id);
+	}
+}
+
+bool TimerWheel::cancel(timer_id_t id)
+{
+	std::unique_lock<decltype(lock)> guard(lock);
+	const bool erased = timers.erase(id) > 0;
+	if (std::this_thread::get_id() != thread.get_id())
+	{
+		finished.wait(guard, [this, id] { return running_id != id; });
+	}
+	return erased;
+}
+
+size_t TimerWheel::size() const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	return timers.size();
+}
+}	 // namespace rd
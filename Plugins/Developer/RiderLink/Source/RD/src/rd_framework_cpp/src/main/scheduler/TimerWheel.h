@@ -0,0 +1,139 @@
+#ifndef RD_CPP_TIMERWHEEL_H
+#define RD_CPP_TIMERWHEEL_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "lifetime/Lifetime.h"
+#include "spdlog/spdlog.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Hierarchical timing wheel executing delayed and periodic actions of the whole process on a single thread.
+ * Scheduling and cancellation are O(1), the thread sleeps until the nearest expiration instead of waking up every tick.
+ * Actions are executed on the wheel thread and therefore must be short and must not block.
+ */
+class RD_FRAMEWORK_API TimerWheel
+{
+public:
+	using timer_id_t = uint64_t;
+
+	using action_t = std::function<void()>;
+
+	using clock_t = std::chrono::steady_clock;
+
+	/**
+	 * \brief Resolution of the wheel, delays are rounded up to a whole number of ticks.
+	 */
+	static constexpr std::chrono::milliseconds TICK = std::chrono::milliseconds(10);
+
+private:
+	static constexpr size_t SLOT_BITS = 6;
+	static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+	static constexpr size_t LEVELS = 4;
+
+	struct Timer
+	{
+		uint64_t expiration;
+		uint64_t period;
+		action_t action;
+	};
+
+	static std::shared_ptr<spdlog::logger> logger;
+
+	mutable std::mutex lock;
+	std::condition_variable wakeup;
+	std::condition_variable finished;
+
+	std::thread thread;
+	bool stopped = false;
+
+	clock_t::time_point start = clock_t::now();
+	uint64_t current_tick = 0;
+
+	timer_id_t next_id = 1;
+	timer_id_t running_id = 0;
+	std::unordered_map<timer_id_t, Timer> timers;
+	// cancelled timers are removed from [timers] only, stale ids in slots are skipped
+	std::array<std::array<std::vector<timer_id_t>, SLOTS>, LEVELS> slots;
+	std::array<size_t, LEVELS> level_sizes{};
+
+	uint64_t tick_of(clock_t::time_point time) const;
+
+	void place(timer_id_t id, uint64_t expiration);
+
+	void cascade(size_t level);
+
+	void advance(uint64_t tick, std::vector<std::pair<timer_id_t, action_t>>& due);
+
+	/**
+	 * \brief The nearest tick after the current one which has a slot to expire or to cascade.
+	 */
+	uint64_t next_event_tick() const;
+
+	clock_t::time_point next_wakeup() const;
+
+	void run();
+
+public:
+	// region ctor/dtor
+
+	TimerWheel();
+
+	TimerWheel(TimerWheel const&) = delete;
+
+	TimerWheel& operator=(TimerWheel const&) = delete;
+
+	virtual ~TimerWheel();
+	// endregion
+
+	/**
+	 * \brief Executes [action] after [delay], then every [period] if it's non-zero.
+	 */
+	timer_id_t schedule(std::chrono::milliseconds delay, action_t action, std::chrono::milliseconds period = {});
+
+	/**
+	 * \brief Same as schedule, but the timer is cancelled when [lifetime] terminates.
+	 */
+	void schedule(Lifetime lifetime, std::chrono::milliseconds delay, action_t action, std::chrono::milliseconds period = {});
+
+	/**
+	 * \brief Cancels timer [id]. If its action is being executed right now, waits until it finishes (unless called from
+	 * the action itself), so the action is guaranteed not to be running once this method returns.
+	 * \return false if the timer has already fired or been cancelled.
+	 */
+	bool cancel(timer_id_t id);
+
+	size_t size() const;
+
+	/**
+	 * \brief global timer wheel for whole application.
+	 */
+	static TimerWheel& Instance()
+	{
+		static TimerWheel globalTimerWheel;
+		return globalTimerWheel;
+	}
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_TIMERWHEEL_H
@@ -0,0 +1,159 @@
+#include "WorkStealingScheduler.h"
+
+#include "util/core_util.h"
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <algorithm>
+
+namespace rd
+{
+namespace
+{
+// the pool and worker the current thread belongs to
+thread_local WorkStealingScheduler const* current_scheduler = nullptr;
+thread_local size_t current_worker = 0;
+}	 // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(Lifetime lifetime, std::string name, size_t thread_count)
+	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
+	, name(std::move(name))
+	, lifetime(lifetime)
+{
+	out_of_order_execution = true;
+
+	const size_t count = thread_count != 0 ? thread_count : (std::max)(1u, std::thread::hardware_concurrency());
+	for (size_t i = 0; i < count; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+	// all queues exist before any thread starts stealing from them
+	for (size_t i = 0; i < count; ++i)
+	{
+		workers[i]->thread = std::thread([this, i] { run(i); });
+	}
+	thread_id = workers.front()->thread.get_id();
+
+	termination_action = lifetime->add_action([this]() { stop(); });
+}
+
+bool WorkStealingScheduler::take(size_t index, util::unique_function<void()>& task)
+{
+	const size_t count = workers.size();
+	for (size_t k = 0; k < count; ++k)
+	{
+		Worker& worker = *workers[(index + k) % count];
+		std::lock_guard<decltype(worker.lock)> guard(worker.lock);
+		if (!worker.tasks.empty())
+		{
+			task = k == 0 ? worker.tasks.pop_front() : worker.tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingScheduler::run(size_t index)
+{
+	current_scheduler = this;
+	current_worker = index;
+	while (true)
+	{
+		util::unique_function<void()> task;
+		if (!take(index, task))
+		{
+			std::unique_lock<decltype(lock)> guard(lock);
+			// a task queued after the check above sees this worker sleeping and notifies it under the lock
+			++sleeping;
+			const bool found = take(index, task);
+			if (!found)
+			{
+				if (stopping)
+				{
+					--sleeping;
+					return;
+				}
+				task_queued.wait(guard);
+			}
+			--sleeping;
+			if (!found)
+			{
+				continue;
+			}
+		}
+		try
+		{
+			task();
+		}
+		catch (std::exception const& e)
+		{
+			log->error("Background task failed, scheduler={}, worker={} | {}", name, index, e.what());
+		}
+		task = nullptr;
+		if (--tasks_executing == 0)
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			tasks_done.notify_all();
+		}
+	}
+}
+
+void WorkStealingScheduler::queue(util::unique_function<void()> action)
+{
+	if (stopping)
+	{
+		return;
+	}
+	const size_t index =
+		current_scheduler == this ? current_worker : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+	++tasks_executing;
+	{
+		Worker& worker = *workers[index];
+		std::lock_guard<decltype(worker.lock)> guard(worker.lock);
+		worker.tasks.push_back(std::move(action));
+	}
+	if (sleeping > 0)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		task_queued.notify_one();
+	}
+}
+
+void WorkStealingScheduler::flush()
+{
+	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
+
+	std::unique_lock<decltype(lock)> guard(lock);
+	tasks_done.wait(guard, [this] { return tasks_executing == 0; });
+}
+
+bool WorkStealingScheduler::is_active() const
+{
+	return current_scheduler == this;
+}
+
+void WorkStealingScheduler::stop()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		stopping = true;
+	}
+	task_queued.notify_all();
+	for (auto& worker : workers)
+	{
+		// stopped by a task, that thread exits after it and the destructor joins it
+		if (worker->thread.joinable() && worker->thread.get_id() != std::this_thread::get_id())
+		{
+			worker->thread.join();
+		}
+	}
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+	// a thread can't join itself, and the pool mustn't outlive the members it runs on
+	RD_ASSERT_MSG(!is_active(), "Scheduler " + name + " is destroyed from a thread of its own pool");
+	lifetime->remove_action(termination_action);
+	stop();
+}
+}	 // namespace rd
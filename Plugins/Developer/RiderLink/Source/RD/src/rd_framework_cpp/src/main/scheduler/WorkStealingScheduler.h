@@ -0,0 +1,96 @@
+#ifndef RD_CPP_WORKSTEALINGSCHEDULER_H
+#define RD_CPP_WORKSTEALINGSCHEDULER_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "scheduler/base/IScheduler.h"
+#include "lifetime/Lifetime.h"
+#include "util/ring_queue.h"
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Runs actions on a pool of threads, each with its own queue. An action queued from a pool thread goes to that
+ * thread's queue, others are spread round-robin, and a thread without work takes actions from the others' queues.
+ * Actions run concurrently and in any order, so it only suits handlers which don't need ordering.
+ */
+class RD_FRAMEWORK_API WorkStealingScheduler : public IScheduler
+{
+	struct Worker
+	{
+		std::mutex lock;
+		util::ring_queue<util::unique_function<void()>> tasks;
+		std::thread thread;
+	};
+
+	std::shared_ptr<spdlog::logger> log;
+	std::string name;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<size_t> next_worker{0};
+
+	// queued and running tasks
+	std::atomic<size_t> tasks_executing{0};
+	// workers waiting for tasks_queued
+	std::atomic<size_t> sleeping{0};
+	std::atomic<bool> stopping{false};
+
+	std::mutex lock;
+	std::condition_variable task_queued;
+	std::condition_variable tasks_done;
+
+	void run(size_t index);
+
+	// takes from the front of the worker's own queue, or steals from the back of another one
+	bool take(size_t index, util::unique_function<void()>& task);
+
+	void stop();
+
+	// removed by the destructor, the lifetime may outlive the scheduler
+	LifetimeImpl::counter_t termination_action = -1;
+
+public:
+	Lifetime lifetime;
+
+	// region ctor/dtor
+
+	/**
+	 * \param thread_count number of threads, the number of hardware threads if 0.
+	 */
+	WorkStealingScheduler(Lifetime lifetime, std::string name, size_t thread_count = 0);
+
+	virtual ~WorkStealingScheduler();
+	// endregion
+
+	void queue(util::unique_function<void()> action) override;
+
+	/**
+	 * \brief Blocks until all queued tasks are executed.
+	 */
+	void flush() override;
+
+	/**
+	 * \return true on any thread of the pool.
+	 */
+	bool is_active() const override;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_WORKSTEALINGSCHEDULER_H
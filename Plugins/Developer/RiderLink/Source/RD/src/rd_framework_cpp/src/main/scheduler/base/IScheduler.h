@@ -6,7 +6,8 @@
 #pragma warning(disable:4251)
 #endif
 
-#include <functional>
+#include "util/unique_function.h"
+
 #include <thread>
 
 #include <rd_framework_export.h>
@@ -30,11 +31,12 @@ public:
 	// endregion
 
 	/**
-	 * \brief Queues the execution of the given [action].
+	 * \brief Queues the execution of the given [action]. Lambdas and std::function convert to the task type, captures of
+	 * up to util::unique_function::INLINE_SIZE bytes are queued without allocating.
 	 *
 	 * \param action to be queued.
 	 */
-	virtual void queue(std::function<void()> action) = 0;
+	virtual void queue(util::unique_function<void()> action) = 0;
 
 	// TO-DO
 	bool out_of_order_execution = false;
@@ -45,7 +47,7 @@ public:
 	 * \brief invoke action immediately if scheduler is active, queue it otherwise.
 	 * \param action to be invoked
 	 */
-	virtual void invoke_or_queue(std::function<void()> action);
+	virtual void invoke_or_queue(util::unique_function<void()> action);
 
 	virtual void flush() = 0;
 
@@ -2,54 +2,86 @@
 
 #include "util/core_util.h"
 
-#include "ctpl_stl.h"
 #include "spdlog/include/spdlog/sinks/stdout_color_sinks.h"
 
 namespace rd
 {
-SingleThreadSchedulerBase::PoolTask::PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler)
-	: f(std::move(f)), scheduler(scheduler)
+SingleThreadSchedulerBase::SingleThreadSchedulerBase(std::string name)
+	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
+	, name(std::move(name))
+	, thread([this] { run(); })
 {
+	thread_id = thread.get_id();
 }
 
-void SingleThreadSchedulerBase::PoolTask::operator()(int id) const
+void SingleThreadSchedulerBase::run()
 {
-	try
-	{
-		f();
-		--scheduler->tasks_executing;
-	}
-	catch (std::exception const& e)
+	while (true)
 	{
-		scheduler->log->error("Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
-		--scheduler->tasks_executing;
+		util::unique_function<void()> task;
+		{
+			std::unique_lock<decltype(lock)> guard(lock);
+			task_queued.wait(guard, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty())
+			{
+				return;
+			}
+			task = tasks.pop_front();
+		}
+		try
+		{
+			task();
+		}
+		catch (std::exception const& e)
+		{
+			log->error("Background task failed, scheduler={} | {}", name, e.what());
+		}
+		// the captures are released before flush returns
+		task = nullptr;
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			if (--tasks_executing == 0)
+			{
+				tasks_done.notify_all();
+			}
+		}
 	}
 }
 
-SingleThreadSchedulerBase::SingleThreadSchedulerBase(std::string name)
-	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
-	, name(std::move(name))
-	, pool(std::make_unique<ctpl::thread_pool>(1))
+void SingleThreadSchedulerBase::stop()
 {
-	RD_ASSERT_THROW_MSG(pool->size() == 1, "Thread pool wasn't properly initalized");
-	thread_id = pool->get_thread(0).get_id();
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		stopping = true;
+	}
+	task_queued.notify_one();
+	// stopped by a task, the thread exits after it and the destructor joins it
+	if (thread.joinable() && !is_active())
+	{
+		thread.join();
+	}
 }
 
 void SingleThreadSchedulerBase::flush()
 {
 	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
 
-	while (tasks_executing != 0)
-	{
-		std::this_thread::yield();
-	}
+	std::unique_lock<decltype(lock)> guard(lock);
+	tasks_done.wait(guard, [this] { return tasks_executing == 0; });
 }
 
-void SingleThreadSchedulerBase::queue(std::function<void()> action)
+void SingleThreadSchedulerBase::queue(util::unique_function<void()> action)
 {
-	++tasks_executing;
-	PoolTask task(action, this);
-	pool->push(std::move(task));
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (stopping)
+		{
+			return;
+		}
+		++tasks_executing;
+		tasks.push_back(std::move(action));
+	}
+	task_queued.notify_one();
 }
 
 bool SingleThreadSchedulerBase::is_active() const
@@ -57,5 +89,10 @@ bool SingleThreadSchedulerBase::is_active() const
 	return thread_id == std::this_thread::get_id();
 }
 
-SingleThreadSchedulerBase::~SingleThreadSchedulerBase() = default;
-}	 // namespace rd
\ No newline at end of file
+SingleThreadSchedulerBase::~SingleThreadSchedulerBase()
+{
+	// the thread can't join itself, and it mustn't outlive the members it runs on
+	RD_ASSERT_MSG(!is_active(), "Scheduler " + name + " is destroyed from its own thread");
+	stop();
+}
+}	 // namespace rd
@@ -8,17 +8,16 @@
 
 #include "scheduler/base/IScheduler.h"
 #include "lifetime/Lifetime.h"
+#include "util/ring_queue.h"
 #include "spdlog/spdlog.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 #include <rd_framework_export.h>
 
-namespace ctpl
-{
-class thread_pool;
-}
-
 namespace rd
 {
 class RD_FRAMEWORK_API SingleThreadSchedulerBase : public IScheduler
@@ -27,20 +26,26 @@ protected:
 	std::shared_ptr<spdlog::logger> log;
 	std::string name;
 
-	std::atomic_uint32_t tasks_executing{0};
-	std::atomic_uint32_t active{0};
-	std::unique_ptr<ctpl::thread_pool> pool;
+	// queued and running tasks, guarded by lock
+	size_t tasks_executing = 0;
+	util::ring_queue<util::unique_function<void()>> tasks;
+	bool stopping = false;
+
+	std::mutex lock;
+	// signalled when a task is queued or the scheduler stops
+	std::condition_variable task_queued;
+	// signalled when tasks_executing drops to zero
+	std::condition_variable tasks_done;
 
-	class PoolTask
-	{
-		std::function<void()> f;
-		SingleThreadSchedulerBase* scheduler;
+	std::thread thread;
 
-	public:
-		explicit PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler);
+	void run();
 
-		void operator()(int id) const;
-	};
+	/**
+	 * \brief Executes the tasks queued so far and stops the thread. Called from a task, only lets the thread exit after
+	 * it, the destructor joins the thread then.
+	 */
+	void stop();
 
 public:
 	// region ctor/dtor
@@ -49,9 +54,12 @@ public:
 	virtual ~SingleThreadSchedulerBase();
 	// endregion
 
+	/**
+	 * \brief Blocks until all queued tasks are executed.
+	 */
 	void flush() override;
 
-	void queue(std::function<void()> action) override;
+	void queue(util::unique_function<void()> action) override;
 
 	bool is_active() const override;
 };
@@ -1,6 +1,7 @@
 #ifndef RD_CPP_ARRAYSERIALIZER_H
 #define RD_CPP_ARRAYSERIALIZER_H
 
+#include "serialization/Polymorphic.h"
 #include "serialization/SerializationCtx.h"
 #include "framework_traits.h"
 
@@ -12,15 +13,49 @@ template <typename S, template <class, class> class C, typename T = typename uti
 	typename A = allocator<value_or_wrapper<T>>>
 class ArraySerializer
 {
+	// elements written by the generated code of [T] itself are copied in one pass, other serializers write their own
+	// prefixes or subclasses, see Buffer::write_fixed_layout_array
+	using fixed_layout = std::integral_constant<bool, util::is_fixed_layout_v<T> && util::is_same_v<S, Polymorphic<T>>>;
+
+	static C<value_or_wrapper<T>, A> read(SerializationCtx& /*ctx*/, Buffer& buffer, std::true_type)
+	{
+		return buffer.read_fixed_layout_array<C, T, A>();
+	}
+
+	static C<value_or_wrapper<T>, A> read(SerializationCtx& ctx, Buffer& buffer, std::false_type)
+	{
+		return buffer.read_array<C, T, A>([&] { return S::read(ctx, buffer); });
+	}
+
+	static void write(SerializationCtx& /*ctx*/, Buffer& buffer, C<value_or_wrapper<T>, A> const& value, std::true_type)
+	{
+		buffer.write_fixed_layout_array<C, T, A>(value);
+	}
+
+	static void write(SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value, std::false_type)
+	{
+		buffer.write_array<C, T, A>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
+	}
+
 public:
 	static C<value_or_wrapper<T>, A> read(SerializationCtx& ctx, Buffer& buffer)
 	{
-		return buffer.read_array<C, T, A>([&] { return S::read(ctx, buffer); });
+		return read(ctx, buffer, fixed_layout{});
 	}
 
 	static void write(SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value)
 	{
-		buffer.write_array<C, T, A>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
+		write(ctx, buffer, value, fixed_layout{});
+	}
+
+	static size_t estimate_size(SerializationCtx& ctx, C<value_or_wrapper<T>, A> const& value)
+	{
+		size_t result = sizeof(int32_t);
+		for (auto const& e : value)
+		{
+			result += estimate_serialized_size<S>(ctx, wrapper::get<T>(e));
+		}
+		return result;
 	}
 };
 }	 // namespace rd
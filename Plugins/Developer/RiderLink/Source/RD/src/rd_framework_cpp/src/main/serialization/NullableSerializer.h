@@ -30,6 +30,16 @@ public:
 	{
 		buffer.write_nullable<T>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
 	}
+
+	static size_t estimate_size(SerializationCtx& ctx, optional<T> const& value)
+	{
+		return sizeof(uint8_t) + (value ? estimate_serialized_size<S>(ctx, *value) : 0);
+	}
+
+	static size_t estimate_size(SerializationCtx& ctx, Wrapper<T> const& value)
+	{
+		return sizeof(uint8_t) + (value ? estimate_serialized_size<S>(ctx, *value) : 0);
+	}
 };
 
 template <typename S>
@@ -48,6 +58,11 @@ public:
 	{
 		buffer.write_nullable<T>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
 	}
+
+	static size_t estimate_size(SerializationCtx& ctx, Wrapper<T> const& value)
+	{
+		return sizeof(uint8_t) + (value ? estimate_serialized_size<S>(ctx, *value) : 0);
+	}
 };
 }	 // namespace rd
 
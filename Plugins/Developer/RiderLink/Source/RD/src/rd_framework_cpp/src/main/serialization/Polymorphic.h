@@ -13,6 +13,43 @@ namespace rd
 class SerializationCtx;
 // endregion
 
+// region estimate_size
+
+template <typename S, typename T, typename = void>
+struct has_estimate_size : std::false_type
+{
+};
+
+template <typename S, typename T>
+struct has_estimate_size<S, T,
+	util::void_t<decltype(S::estimate_size(std::declval<SerializationCtx&>(), std::declval<T const&>()))>> : std::true_type
+{
+};
+
+template <typename S, typename T>
+size_t estimate_serialized_size(SerializationCtx& ctx, T const& value, std::true_type)
+{
+	return S::estimate_size(ctx, value);
+}
+
+template <typename S, typename T>
+size_t estimate_serialized_size(SerializationCtx& /*ctx*/, T const& /*value*/, std::false_type)
+{
+	return 0;
+}
+
+/**
+ * \brief Number of bytes S::write is expected to write for [value], 0 if unknown. Serializers may provide it as
+ * static "estimate_size(ctx, value)", senders pass it as the size hint of IWire::send to allocate the message once.
+ */
+template <typename S, typename T>
+size_t estimate_serialized_size(SerializationCtx& ctx, T const& value)
+{
+	return estimate_serialized_size<S>(ctx, value, has_estimate_size<S, T>{});
+}
+
+// endregion
+
 /**
  * \brief Maintains "SerDes" for statically polymorphic type [T].
  * Requires static "read" and "write" methods as in common case below.
@@ -37,6 +74,38 @@ public:
 	{
 		value->write(ctx, buffer);
 	}
+
+	/**
+	 * \brief Sum of the estimates of the fields for generated classes with the tuple trait, 0 for other classes.
+	 */
+	inline static size_t estimate_size(SerializationCtx& ctx, T const& value)
+	{
+		return estimate_fields(ctx, value, util::has_tuple_size<T>{});
+	}
+
+private:
+	inline static size_t estimate_fields(SerializationCtx& ctx, T const& value, std::true_type)
+	{
+		return estimate_fields(ctx, value, std::make_index_sequence<std::tuple_size<T>::value>{});
+	}
+
+	inline static size_t estimate_fields(SerializationCtx& /*ctx*/, T const& /*value*/, std::false_type)
+	{
+		return 0;
+	}
+
+	template <size_t... I>
+	inline static size_t estimate_fields(SerializationCtx& ctx, T const& value, std::index_sequence<I...>)
+	{
+		size_t result = 0;
+		const size_t sizes[] = {0, estimate_serialized_size<Polymorphic<util::fixed_layout_field_t<T, I>>>(
+									   ctx, value.template get<I>())...};
+		for (size_t size : sizes)
+		{
+			result += size;
+		}
+		return result;
+	}
 };
 
 template <typename T>
@@ -45,12 +114,17 @@ class Polymorphic<T, typename std::enable_if_t<std::is_integral<T>::value>>
 public:
 	inline static T read(SerializationCtx& /*ctx*/, Buffer& buffer)
 	{
-		return buffer.read_integral<T>();
+		return buffer.read_packed_integral<T>();
 	}
 
 	inline static void write(SerializationCtx& /*ctx*/, Buffer& buffer, T const& value)
 	{
-		buffer.write_integral<T>(value);
+		buffer.write_packed_integral<T>(value);
+	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(T);
 	}
 };
 
@@ -67,6 +141,11 @@ public:
 	{
 		buffer.write_floating_point<T>(value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(T);
+	}
 };
 
 // class Polymorphic<int, void>;
@@ -85,6 +164,28 @@ public:
 	{
 		buffer.write_array<C, T, A>(value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& ctx, C<T, A> const& value)
+	{
+		return sizeof(int32_t) + estimate_elements(ctx, value, std::is_arithmetic<T>{});
+	}
+
+private:
+	inline static size_t estimate_elements(SerializationCtx& /*ctx*/, C<T, A> const& value, std::true_type)
+	{
+		using rd::size;
+		return sizeof(T) * static_cast<size_t>(size(value));
+	}
+
+	inline static size_t estimate_elements(SerializationCtx& ctx, C<T, A> const& value, std::false_type)
+	{
+		size_t result = 0;
+		for (auto const& e : value)
+		{
+			result += estimate_serialized_size<Polymorphic<T>>(ctx, e);
+		}
+		return result;
+	}
 };
 
 template <>
@@ -100,6 +201,11 @@ public:
 	{
 		buffer.write_bool(value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, bool const& /*value*/)
+	{
+		return sizeof(uint8_t);
+	}
 };
 
 template <>
@@ -115,6 +221,11 @@ public:
 	{
 		buffer.write_char(value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, wchar_t const& /*value*/)
+	{
+		return sizeof(uint16_t);
+	}
 };
 
 template <>
@@ -135,6 +246,12 @@ public:
 	{
 		buffer.write_wstring(*value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, std::wstring const& value)
+	{
+		// UTF-16 code units, exact unless the string has characters beyond the BMP
+		return sizeof(int32_t) + sizeof(uint16_t) * value.size();
+	}
 };
 
 template <>
@@ -150,6 +267,11 @@ public:
 	{
 		buffer.write_date_time(value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, DateTime const& /*value*/)
+	{
+		return sizeof(int64_t);
+	}
 };
 
 template <>
@@ -164,6 +286,11 @@ public:
 	inline static void write(SerializationCtx& /*ctx*/, Buffer& /*buffer*/, Void const& /*value*/)
 	{
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, Void const& /*value*/)
+	{
+		return 0;
+	}
 };
 
 template <typename T>
@@ -194,6 +321,11 @@ public:
 	{
 		buffer.write_enum<T>(value);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(int32_t);
+	}
 };
 
 template <typename T>
@@ -209,6 +341,11 @@ public:
 	{
 		buffer.write_nullable<T>(value, [&ctx, &buffer](T const& v) { Polymorphic<T>::write(ctx, buffer, v); });
 	}
+
+	inline static size_t estimate_size(SerializationCtx& ctx, optional<T> const& value)
+	{
+		return sizeof(uint8_t) + (value ? estimate_serialized_size<Polymorphic<T>>(ctx, *value) : 0);
+	}
 };
 
 template <typename T, typename A>
@@ -219,6 +356,11 @@ public:
 	{
 		value->write(ctx, buffer);
 	}
+
+	inline static size_t estimate_size(SerializationCtx& ctx, Wrapper<T, A> const& value)
+	{
+		return value ? estimate_serialized_size<Polymorphic<T>>(ctx, *value) : 0;
+	}
 };
 }	 // namespace rd
 
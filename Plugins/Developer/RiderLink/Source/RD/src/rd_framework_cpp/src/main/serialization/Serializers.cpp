@@ -11,8 +11,13 @@ RdId Serializers::real_rd_id(const IUnknownInstance& value)
 	return value.unknownId;
 }
 
-RdId Serializers::real_rd_id(const IPolymorphicSerializable& value)
+RdId Serializers::real_rd_id(const IPolymorphicSerializable& value) const
 {
+	RdId const* id = type_ids.find(&typeid(value));
+	if (id != nullptr)
+	{
+		return *id;
+	}
 	return RdId(util::getPlatformIndependentHash(value.type_name()));
 }
 
@@ -38,9 +43,9 @@ void Serializers::real_write(SerializationCtx& ctx, Buffer& buffer, std::wstring
 
 void Serializers::register_in()
 {
-	readers[STRING_PREDEFINED_ID] = [](SerializationCtx& ctx, Buffer& buffer) -> InternedAny {
+	readers.insert(STRING_PREDEFINED_ID, [](SerializationCtx& ctx, Buffer& buffer) -> InternedAny {
 		return {wrapper::make_wrapper<std::wstring>(Polymorphic<std::wstring>::read(ctx, buffer))};
-	};
+	});
 }
 
 Serializers::Serializers()
@@ -14,10 +14,11 @@
 #include "serialization/RdAny.h"
 #include "DefaultAbstractDeclaration.h"
 
-#include "std/unordered_map.h"
+#include "util/FlatMap.h"
 
 #include <utility>
 #include <iostream>
+#include <typeinfo>
 #include <unordered_set>
 
 #include <rd_framework_export.h>
@@ -34,7 +35,7 @@ class RD_FRAMEWORK_API Serializers
 private:
 	static RdId real_rd_id(IUnknownInstance const& value);
 
-	static RdId real_rd_id(IPolymorphicSerializable const& value);
+	RdId real_rd_id(IPolymorphicSerializable const& value) const;
 
 	static RdId real_rd_id(std::wstring const& value);
 
@@ -46,7 +47,13 @@ private:
 
 	void register_in();
 
-	mutable rd::unordered_map<RdId, std::function<InternedAny(SerializationCtx&, Buffer&)>> readers;
+	mutable util::flat_map<RdId, std::function<InternedAny(SerializationCtx&, Buffer&)>> readers;
+
+	/**
+	 * \brief Ids of the registered types by their type_info, so that writing doesn't hash type_name() every time.
+	 * A type_info may be duplicated across modules, such types just take the slow path.
+	 */
+	mutable util::flat_map<std::type_info const*, RdId> type_ids;
 
 public:
 	Serializers();
@@ -83,11 +90,12 @@ void Serializers::registry() const
 	util::hash_t h = util::getPlatformIndependentHash(type_name);
 	RdId id(h);
 
-	RD_ASSERT_MSG(readers.count(id) == 0, "Can't register " + type_name + " with id: " + to_string(id));
+	RD_ASSERT_MSG(!readers.contains(id), "Can't register " + type_name + " with id: " + to_string(id));
 
-	readers[id] = [](SerializationCtx& ctx, Buffer& buffer) -> Wrapper<IPolymorphicSerializable> {
+	readers.insert(id, [](SerializationCtx& ctx, Buffer& buffer) -> Wrapper<IPolymorphicSerializable> {
 		return wrapper::make_wrapper<T>(T::read(ctx, buffer));
-	};
+	});
+	type_ids.insert(&typeid(T), id);
 }
 
 template <typename T>
@@ -101,12 +109,12 @@ optional<InternedAny> Serializers::readAny(SerializationCtx& ctx, Buffer& buffer
 	int32_t size = buffer.read_integral<int32_t>();
 	buffer.check_available(static_cast<size_t>(size));
 
-	if (readers.count(id) == 0)
+	auto const* reader = readers.find(id);
+	if (reader == nullptr)
 	{
 		return any::make_interned_any<T>(T::readUnknownInstance(ctx, buffer, id, size));
 	}
-	auto const& reader = readers.at(id);
-	return reader(ctx, buffer);
+	return (*reader)(ctx, buffer);
 }
 
 template <typename T>
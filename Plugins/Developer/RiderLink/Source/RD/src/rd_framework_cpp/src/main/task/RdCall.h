@@ -5,9 +5,11 @@
 #include "RdTask.h"
 #include "RdTaskResult.h"
 #include "scheduler/SynchronousScheduler.h"
+#include "scheduler/TimerWheel.h"
 #include "WiredRdTask.h"
 
-#include <thread>
+#include <condition_variable>
+#include <mutex>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -71,13 +73,30 @@ public:
 	 */
 	WiredRdTask<TRes, ResSer> sync(TReq const& request, std::chrono::milliseconds timeout = 200ms) const
 	{
-		auto task = start_internal(request, true, &SynchronousScheduler::Instance());
-		auto time_at_start = std::chrono::system_clock::now();
-		while (!task.has_value() && !(*bind_lifetime)->is_terminated() &&
-			   ((std::chrono::system_clock::now() - time_at_start) < timeout))
+		// the response (or cancellation on termination of the call) is set on the receiving thread, which wakes the caller up
+		struct completion_t
 		{
-			std::this_thread::yield();
-		}
+			std::mutex lock;
+			std::condition_variable cv;
+			bool done = false;
+		};
+		auto completion = std::make_shared<completion_t>();
+		auto time_at_start = std::chrono::system_clock::now();
+		auto task = LifetimeDefinition::use([&](Lifetime lifetime) {
+			auto result = start_internal(request, true, &SynchronousScheduler::Instance(),
+				[&](WiredRdTask<TRes, ResSer> const& it) {
+					it.advise(lifetime, [completion](RdTaskResult<TRes, ResSer> const&) {
+						{
+							std::lock_guard<std::mutex> guard(completion->lock);
+							completion->done = true;
+						}
+						completion->cv.notify_all();
+					});
+				});
+			std::unique_lock<std::mutex> guard(completion->lock);
+			completion->cv.wait_for(guard, timeout, [&completion] { return completion->done; });
+			return result;
+		});
 		spdlog::debug("Time elapsed: {}, has_value={}", to_string(std::chrono::system_clock::now() - time_at_start),
 			to_string(task.has_value()));
 		task.value_or_throw().unwrap();	   // check for existing value
@@ -102,13 +121,40 @@ public:
 		return start_internal(request, false, responseScheduler ? responseScheduler : get_default_scheduler());
 	}
 
+	/**
+	 * \brief Same as start, but the task is cancelled if the response doesn't arrive within [timeout].
+	 *
+	 * \param request value of request
+	 * \param timeout to wait for the response
+	 * \param responseScheduler to assign value
+	 * \return task which will have its result value.
+	 */
+	WiredRdTask<TRes, ResSer> start(
+		TReq const& request, std::chrono::milliseconds timeout, IScheduler* responseScheduler = nullptr) const
+	{
+		IScheduler* scheduler = responseScheduler ? responseScheduler : get_default_scheduler();
+		return start_internal(request, false, scheduler, [&](WiredRdTask<TRes, ResSer> const& task) {
+			// the timer is cancelled as soon as the task has a result or the call is unbound
+			auto timeout_definition = std::make_shared<LifetimeDefinition>(*bind_lifetime);
+			TimerWheel::Instance().schedule(timeout_definition->lifetime, timeout, [task, scheduler] {
+				scheduler->queue([task] { task.set_result_if_empty(typename RdTaskResult<TRes, ResSer>::Cancelled()); });
+			});
+			task.advise(timeout_definition->lifetime,
+				[timeout_definition](RdTaskResult<TRes, ResSer> const&) { timeout_definition->terminate(); });
+		});
+	}
+
 	void on_wire_received(Buffer buffer) const override
 	{
 		RD_ASSERT_MSG(false, "RdCall.on_wire_received called")
 	}
 
 private:
-	WiredRdTask<TRes, ResSer> start_internal(TReq const& request, bool sync, IScheduler* scheduler) const
+	/**
+	 * \brief Sends [request] as a new task, [prepare] is called with the task before the response can possibly arrive.
+	 */
+	WiredRdTask<TRes, ResSer> start_internal(TReq const& request, bool sync, IScheduler* scheduler,
+		std::function<void(WiredRdTask<TRes, ResSer> const&)> prepare = {}) const
 	{
 		assert_bound();
 		if (!async)
@@ -129,12 +175,20 @@ private:
 			sync_task_id = task_id;
 		}
 
-		get_wire()->send(rdid, [&](Buffer& buffer) {
-			spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
-				to_string(task_id), to_string(request));
-			task_id.write(buffer);
-			ReqSer::write(get_serialization_context(), buffer, request);
-		});
+		if (prepare)
+		{
+			prepare(task);
+		}
+
+		get_wire()->send(
+			rdid,
+			[&](Buffer& buffer) {
+				spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid),
+					(sync ? "SYNC" : "ASYNC"), to_string(task_id), to_string(request));
+				task_id.write(buffer);
+				ReqSer::write(get_serialization_context(), buffer, request);
+			},
+			sizeof(RdId::hash_t) + estimate_serialized_size<ReqSer>(get_serialization_context(), request));
 
 		return task;
 	}
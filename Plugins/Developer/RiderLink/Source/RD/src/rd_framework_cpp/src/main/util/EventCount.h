@@ -0,0 +1,84 @@
+#ifndef RD_CPP_EVENTCOUNT_H
+#define RD_CPP_EVENTCOUNT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Condition variable for lock-free data structures. Notifying costs a fence and a load unless somebody waits.
+ *
+ * Waiter protocol:
+ * \code
+ * auto key = event.prepare_wait();
+ * if (condition()) { event.cancel_wait(key); } else { event.wait(key); }
+ * \endcode
+ * Notifications issued after prepare_wait are never lost.
+ */
+class event_count
+{
+	static constexpr uint64_t WAITERS_MASK = (uint64_t(1) << 32) - 1;
+	static constexpr uint64_t EPOCH_INCREMENT = uint64_t(1) << 32;
+
+	// epoch in the high half, number of prepared waiters in the low one
+	std::atomic<uint64_t> state{0};
+
+	std::mutex lock;
+	std::condition_variable cv;
+
+public:
+	using key_t = uint32_t;
+
+	key_t prepare_wait()
+	{
+		const uint64_t prev = state.fetch_add(1);
+		// pairs with the fence in notify: either the notifier sees this waiter or the waiter sees the new data
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		return static_cast<key_t>(prev >> 32);
+	}
+
+	void cancel_wait(key_t key)
+	{
+		uint64_t current = state.load();
+		// if the epoch has changed, a notifier has already released this waiter
+		while (static_cast<key_t>(current >> 32) == key)
+		{
+			if (state.compare_exchange_weak(current, current - 1))
+			{
+				return;
+			}
+		}
+	}
+
+	void wait(key_t key)
+	{
+		std::unique_lock<decltype(lock)> guard(lock);
+		cv.wait(guard, [this, key] { return static_cast<key_t>(state.load() >> 32) != key; });
+	}
+
+	void notify()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		uint64_t current = state.load(std::memory_order_relaxed);
+		while ((current & WAITERS_MASK) != 0)
+		{
+			// release all prepared waiters at once and advance the epoch, so later notifications are cheap again
+			if (state.compare_exchange_weak(current, (current & ~WAITERS_MASK) + EPOCH_INCREMENT))
+			{
+				// the lock orders this notification after the waiter's check of the epoch
+				std::lock_guard<decltype(lock)> guard(lock);
+				cv.notify_all();
+				return;
+			}
+		}
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_EVENTCOUNT_H
@@ -0,0 +1,135 @@
+#ifndef RD_CPP_FLATMAP_H
+#define RD_CPP_FLATMAP_H
+
+#include "std/hash.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Insert-only hash map with open addressing and linear probing over a single array of slots. A lookup is
+ * a multiplication and, for a table at most half full, one or two adjacent slots, with no pointer chasing.
+ * Meant for registries filled once and then read on every message.
+ */
+template <typename K, typename V, typename H = rd::hash<K>>
+class flat_map
+{
+	struct slot
+	{
+		bool used = false;
+		K key{};
+		V value{};
+	};
+
+	static constexpr size_t INITIAL_CAPACITY = 16;
+
+	std::vector<slot> slots;
+	size_t count = 0;
+	// capacity is 2^bits
+	unsigned bits = 0;
+
+	size_t index_of(K const& key) const
+	{
+		// Fibonacci hashing spreads keys whose hashes differ only in the high or only in the low bits
+		const uint64_t h = static_cast<uint64_t>(H()(key)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(h >> (64 - bits));
+	}
+
+	size_t find_index(K const& key) const
+	{
+		if (count == 0)
+		{
+			return slots.size();
+		}
+		const size_t mask = slots.size() - 1;
+		for (size_t i = index_of(key);; i = (i + 1) & mask)
+		{
+			slot const& s = slots[i];
+			if (!s.used)
+			{
+				return slots.size();
+			}
+			if (s.key == key)
+			{
+				return i;
+			}
+		}
+	}
+
+	void place(K key, V value)
+	{
+		const size_t mask = slots.size() - 1;
+		size_t i = index_of(key);
+		while (slots[i].used)
+		{
+			i = (i + 1) & mask;
+		}
+		slots[i].used = true;
+		slots[i].key = std::move(key);
+		slots[i].value = std::move(value);
+	}
+
+	void grow()
+	{
+		std::vector<slot> old = std::move(slots);
+		slots = std::vector<slot>(old.empty() ? INITIAL_CAPACITY : old.size() * 2);
+		bits = 0;
+		while ((size_t(1) << bits) < slots.size())
+		{
+			++bits;
+		}
+		for (slot& s : old)
+		{
+			if (s.used)
+			{
+				place(std::move(s.key), std::move(s.value));
+			}
+		}
+	}
+
+public:
+	V const* find(K const& key) const
+	{
+		const size_t i = find_index(key);
+		return i == slots.size() ? nullptr : &slots[i].value;
+	}
+
+	bool contains(K const& key) const
+	{
+		return find(key) != nullptr;
+	}
+
+	/**
+	 * \brief Adds [value] under [key] unless the key is already present.
+	 * \return true if the value was added.
+	 */
+	bool insert(K key, V value)
+	{
+		if (find_index(key) != slots.size())
+		{
+			return false;
+		}
+		// keep the load factor at most 1/2
+		if (2 * (count + 1) > slots.size())
+		{
+			grow();
+		}
+		place(std::move(key), std::move(value));
+		++count;
+		return true;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_FLATMAP_H
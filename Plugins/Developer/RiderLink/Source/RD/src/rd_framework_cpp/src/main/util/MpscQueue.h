@@ -0,0 +1,185 @@
+#ifndef RD_CPP_MPSCQUEUE_H
+#define RD_CPP_MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Unbounded lock-free multi-producer single-consumer queue (intrusive linked list with a stub node).
+ * push is wait-free and may be called from any thread, pop and drain must be called from a single consumer thread.
+ * An element being pushed concurrently may be invisible to the consumer for a short time, so producers are expected
+ * to notify the consumer after push (see event_count).
+ * Consumed nodes are kept on a free list and reused by push, so once the queue has seen its usual depth, pushing
+ * doesn't allocate. A producer which finds the free list taken by another one allocates rather than waits.
+ */
+template <typename T>
+class mpsc_queue
+{
+	struct node
+	{
+		std::atomic<node*> next{nullptr};
+		// link in the chains of free nodes
+		node* next_free = nullptr;
+		T value;
+
+		node() = default;
+
+		explicit node(T&& value) : value(std::move(value))
+		{
+		}
+	};
+
+	alignas(64) std::atomic<node*> head;
+	// nodes taken from [free_nodes] by a producer holding [free_pop_lock]
+	node* producer_cache = nullptr;
+	std::atomic_flag free_pop_lock = ATOMIC_FLAG_INIT;
+
+	alignas(64) node* tail;
+	// nodes consumed since the last publish, from the latest to the first
+	node* released_first = nullptr;
+	node* released_last = nullptr;
+
+	// consumed nodes handed back to producers, the consumer publishes one chain per pop or drain and a producer takes
+	// all of them at once, so neither side pays an atomic operation per node and there's no ABA
+	alignas(64) std::atomic<node*> free_nodes{nullptr};
+
+	node* acquire_node(T&& value)
+	{
+		node* n = nullptr;
+		if (!free_pop_lock.test_and_set(std::memory_order_acquire))
+		{
+			if (producer_cache == nullptr)
+			{
+				producer_cache = free_nodes.exchange(nullptr, std::memory_order_acquire);
+			}
+			n = producer_cache;
+			if (n != nullptr)
+			{
+				producer_cache = n->next_free;
+			}
+			free_pop_lock.clear(std::memory_order_release);
+		}
+		if (n == nullptr)
+		{
+			return new node(std::move(value));
+		}
+		n->next.store(nullptr, std::memory_order_relaxed);
+		n->value = std::move(value);
+		return n;
+	}
+
+	void release_node(node* n)
+	{
+		n->next_free = released_first;
+		released_first = n;
+		if (released_last == nullptr)
+		{
+			released_last = n;
+		}
+	}
+
+	void publish_released()
+	{
+		if (released_first == nullptr)
+		{
+			return;
+		}
+		released_last->next_free = free_nodes.load(std::memory_order_relaxed);
+		while (!free_nodes.compare_exchange_weak(
+			released_last->next_free, released_first, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		released_first = nullptr;
+		released_last = nullptr;
+	}
+
+	static void delete_chain(node* n)
+	{
+		while (n != nullptr)
+		{
+			node* next = n->next_free;
+			delete n;
+			n = next;
+		}
+	}
+
+public:
+	// region ctor/dtor
+
+	mpsc_queue() : head(new node()), tail(head.load())
+	{
+	}
+
+	mpsc_queue(mpsc_queue const&) = delete;
+
+	mpsc_queue& operator=(mpsc_queue const&) = delete;
+
+	~mpsc_queue()
+	{
+		T value;
+		while (pop(value))
+		{
+		}
+		delete tail;
+		delete_chain(free_nodes.load());
+		delete_chain(producer_cache);
+		delete_chain(released_first);
+	}
+
+	// endregion
+
+	void push(T value)
+	{
+		node* n = acquire_node(std::move(value));
+		node* prev = head.exchange(n, std::memory_order_acq_rel);
+		prev->next.store(n, std::memory_order_release);
+	}
+
+	bool pop(T& value)
+	{
+		node* next = tail->next.load(std::memory_order_acquire);
+		if (next == nullptr)
+		{
+			return false;
+		}
+		value = std::move(next->value);
+		release_node(tail);
+		tail = next;
+		publish_released();
+		return true;
+	}
+
+	/**
+	 * \brief Pops all visible elements passing them to [f] in FIFO order.
+	 * \return number of popped elements.
+	 */
+	template <typename F>
+	size_t drain(F&& f)
+	{
+		size_t count = 0;
+		node* next;
+		while ((next = tail->next.load(std::memory_order_acquire)) != nullptr)
+		{
+			f(std::move(next->value));
+			release_node(tail);
+			tail = next;
+			++count;
+		}
+		publish_released();
+		return count;
+	}
+
+	bool empty() const
+	{
+		return tail->next.load(std::memory_order_acquire) == nullptr;
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_MPSCQUEUE_H
@@ -0,0 +1,234 @@
+#include "compression.h"
+
+#include <array>
+#include <cstring>
+
+namespace rd
+{
+namespace util
+{
+namespace
+{
+constexpr size_t MIN_MATCH = 4;
+// the format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MF_LIMIT = 12;
+constexpr size_t MAX_DISTANCE = 65535;
+constexpr size_t HASH_LOG = 12;
+// every 64 failed probes in a row the step grows, so incompressible data is skipped quickly
+constexpr size_t SKIP_TRIGGER = 6;
+
+uint32_t read32(uint8_t const* p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+uint32_t hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+uint8_t* write_length(uint8_t* op, size_t length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		*op++ = 255;
+	}
+	*op++ = static_cast<uint8_t>(length);
+	return op;
+}
+
+bool read_length(uint8_t const*& ip, uint8_t const* iend, size_t& length)
+{
+	uint8_t b;
+	do
+	{
+		if (ip >= iend)
+		{
+			return false;
+		}
+		b = *ip++;
+		length += b;
+	} while (b == 255);
+	return true;
+}
+
+// emits literals [anchor, anchor + literals) followed by a match, the last sequence of a block has no match
+uint8_t* write_sequence(uint8_t* op, uint8_t const* anchor, size_t literals, size_t offset, size_t match_length)
+{
+	uint8_t* token = op++;
+	*token = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+	if (literals >= 15)
+	{
+		op = write_length(op, literals - 15);
+	}
+	if (literals > 0)
+	{
+		memcpy(op, anchor, literals);
+		op += literals;
+	}
+	if (match_length == 0)
+	{
+		return op;
+	}
+	*op++ = static_cast<uint8_t>(offset);
+	*op++ = static_cast<uint8_t>(offset >> 8);
+	const size_t extra = match_length - MIN_MATCH;
+	*token |= static_cast<uint8_t>(extra >= 15 ? 15 : extra);
+	if (extra >= 15)
+	{
+		op = write_length(op, extra - 15);
+	}
+	return op;
+}
+
+// upper bound of bytes written by write_sequence
+size_t sequence_bound(size_t literals, size_t match_length)
+{
+	return 1 + literals / 255 + 1 + literals + 2 + match_length / 255 + 1;
+}
+}	 // namespace
+
+size_t lz_compress_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t lz_compress(uint8_t const* src, size_t size, uint8_t* dst, size_t dst_capacity)
+{
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + dst_capacity;
+	size_t anchor = 0;
+
+	if (size > MF_LIMIT)
+	{
+		// positions are stored relative to [src], a zero entry is just a candidate that fails verification
+		std::array<uint32_t, size_t(1) << HASH_LOG> table{};
+		const size_t match_limit = size - LAST_LITERALS;
+		const size_t mf_limit = size - MF_LIMIT;
+
+		size_t ip = 1;
+		while (ip < mf_limit)
+		{
+			const uint32_t sequence = read32(src + ip);
+			const uint32_t h = hash(sequence);
+			size_t ref = table[h];
+			table[h] = static_cast<uint32_t>(ip);
+			if (ref >= ip || ip - ref > MAX_DISTANCE || read32(src + ref) != sequence)
+			{
+				ip += 1 + ((ip - anchor) >> SKIP_TRIGGER);
+				continue;
+			}
+
+			while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+			{
+				--ip;
+				--ref;
+			}
+			size_t length = MIN_MATCH;
+			while (ip + length < match_limit && src[ip + length] == src[ref + length])
+			{
+				++length;
+			}
+
+			const size_t literals = ip - anchor;
+			if (static_cast<size_t>(oend - op) < sequence_bound(literals, length))
+			{
+				return 0;
+			}
+			op = write_sequence(op, src + anchor, literals, ip - ref, length);
+
+			ip += length;
+			anchor = ip;
+			if (ip < mf_limit)
+			{
+				table[hash(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+			}
+		}
+	}
+
+	const size_t literals = size - anchor;
+	if (static_cast<size_t>(oend - op) < sequence_bound(literals, 0))
+	{
+		return 0;
+	}
+	op = write_sequence(op, src + anchor, literals, 0, 0);
+	return static_cast<size_t>(op - dst);
+}
+
+bool lz_decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t original_size)
+{
+	uint8_t const* ip = src;
+	uint8_t const* const iend = src + size;
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + original_size;
+
+	while (ip < iend)
+	{
+		const uint8_t token = *ip++;
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !read_length(ip, iend, literals))
+		{
+			return false;
+		}
+		if (literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op))
+		{
+			return false;
+		}
+		if (literals > 0)
+		{
+			memcpy(op, ip, literals);
+			ip += literals;
+			op += literals;
+		}
+
+		if (ip == iend)
+		{
+			// the last sequence consists of literals only
+			break;
+		}
+
+		if (iend - ip < 2)
+		{
+			return false;
+		}
+		const size_t offset = ip[0] | (size_t(ip[1]) << 8);
+		ip += 2;
+		if (offset == 0 || offset > static_cast<size_t>(op - dst))
+		{
+			return false;
+		}
+
+		size_t length = token & 15;
+		if (length == 15 && !read_length(ip, iend, length))
+		{
+			return false;
+		}
+		length += MIN_MATCH;
+		if (length > static_cast<size_t>(oend - op))
+		{
+			return false;
+		}
+
+		uint8_t const* match = op - offset;
+		if (offset >= length)
+		{
+			memcpy(op, match, length);
+			op += length;
+		}
+		else
+		{
+			// overlapping match repeats the last [offset] bytes
+			for (size_t i = 0; i < length; ++i)
+			{
+				*op++ = match[i];
+			}
+		}
+	}
+	return op == oend;
+}
+}	 // namespace util
+}	 // namespace rd
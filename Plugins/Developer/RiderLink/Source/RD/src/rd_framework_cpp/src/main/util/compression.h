@@ -0,0 +1,34 @@
+#ifndef RD_CPP_COMPRESSION_H
+#define RD_CPP_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Maximum size of the block produced by \ref lz_compress for [size] bytes of input.
+ */
+size_t RD_FRAMEWORK_API lz_compress_bound(size_t size);
+
+/**
+ * \brief Compresses [size] bytes of [src] into [dst] in the LZ4 block format with a greedy single-probe matcher.
+ * It favors speed over ratio, which suits repetitive data such as log text.
+ * \return size of the compressed block, 0 if it doesn't fit into [dst_capacity].
+ */
+size_t RD_FRAMEWORK_API lz_compress(uint8_t const* src, size_t size, uint8_t* dst, size_t dst_capacity);
+
+/**
+ * \brief Decompresses the block of [size] bytes produced by \ref lz_compress into exactly [original_size] bytes of [dst].
+ * Malformed input is detected and never read or written out of bounds.
+ * \return false if [src] is malformed or doesn't decompress into [original_size] bytes.
+ */
+bool RD_FRAMEWORK_API lz_decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t original_size);
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_COMPRESSION_H
@@ -0,0 +1,142 @@
+#ifndef RD_CPP_FIXED_LAYOUT_H
+#define RD_CPP_FIXED_LAYOUT_H
+
+#include "serialization/ISerializable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+// region fixed_layout
+
+/**
+ * \brief Generated data classes expose their fields through the tuple trait (std::tuple_size and get<I>).
+ * A class whose fields are all plain numbers is serialized by its generated code as the fields' bytes one after
+ * another, so a whole array of such objects can be read and written in one pass over a single reserved block.
+ */
+template <typename T, typename = void>
+struct has_tuple_size : std::false_type
+{
+};
+
+template <typename T>
+struct has_tuple_size<T, std::enable_if_t<(std::tuple_size<T>::value > 0)>> : std::true_type
+{
+};
+
+template <typename F>
+using is_fixed_layout_field =
+	std::integral_constant<bool, std::is_floating_point<F>::value ||
+									 (std::is_integral<F>::value && !std::is_same<F, bool>::value &&
+										 !std::is_same<F, wchar_t>::value && !std::is_same<F, char16_t>::value &&
+										 !std::is_same<F, char32_t>::value)>;
+
+template <typename T, size_t I>
+using fixed_layout_field_t = std::decay_t<std::tuple_element_t<I, T>>;
+
+template <typename T, typename Seq = std::make_index_sequence<std::tuple_size<T>::value>>
+struct fixed_layout_fields;
+
+template <typename T, size_t... I>
+struct fixed_layout_fields<T, std::index_sequence<I...>>
+{
+	// the primary constructor takes the fields in declaration order, the generated read calls it the same way
+	static constexpr bool value = conjunction<is_fixed_layout_field<fixed_layout_field_t<T, I>>...>::value &&
+								  std::is_constructible<T, fixed_layout_field_t<T, I>...>::value;
+
+	/**
+	 * \brief Position of field [index] in the serialized object, the size of the whole object for index == field count.
+	 */
+	static constexpr size_t offset(size_t index)
+	{
+		const size_t sizes[] = {sizeof(fixed_layout_field_t<T, I>)...};
+		size_t result = 0;
+		for (size_t i = 0; i < index; ++i)
+		{
+			result += sizes[i];
+		}
+		return result;
+	}
+};
+
+template <typename T, typename = void>
+struct is_fixed_layout : std::false_type
+{
+};
+
+template <typename T>
+struct is_fixed_layout<T, std::enable_if_t<has_tuple_size<T>::value && std::is_base_of<IPolymorphicSerializable, T>::value &&
+											   !std::is_abstract<T>::value>>
+	: std::integral_constant<bool, fixed_layout_fields<T>::value>
+{
+};
+
+template <typename T>
+constexpr bool is_fixed_layout_v = is_fixed_layout<T>::value;
+
+/**
+ * \brief Number of bytes the generated code writes for [T].
+ */
+template <typename T>
+constexpr size_t fixed_layout_size_v = fixed_layout_fields<T>::offset(std::tuple_size<T>::value);
+
+template <typename F>
+uint8_t* store_fixed_layout_field(uint8_t* dst, F const& field)
+{
+	memcpy(dst, &field, sizeof(F));
+	return dst + sizeof(F);
+}
+
+template <typename T, size_t... I>
+void store_fixed_layout(T const& value, uint8_t* dst, std::index_sequence<I...>)
+{
+	// braced initializers are evaluated in order
+	uint8_t* unused[] = {dst, (dst = store_fixed_layout_field(dst, value.template get<I>()))...};
+	(void) unused;
+}
+
+/**
+ * \brief Writes the fields of [value] into [dst] exactly as its generated write does.
+ */
+template <typename T>
+void store_fixed_layout(T const& value, uint8_t* dst)
+{
+	store_fixed_layout(value, dst, std::make_index_sequence<std::tuple_size<T>::value>{});
+}
+
+template <typename F>
+F load_fixed_layout_field(uint8_t const* src)
+{
+	F field;
+	memcpy(&field, src, sizeof(F));
+	return field;
+}
+
+template <typename T, typename F, size_t... I>
+decltype(auto) load_fixed_layout(uint8_t const* src, F&& make, std::index_sequence<I...>)
+{
+	return make(load_fixed_layout_field<fixed_layout_field_t<T, I>>(src + fixed_layout_fields<T>::offset(I))...);
+}
+
+/**
+ * \brief Reads the fields written by \ref store_fixed_layout and passes them to [make] in declaration order,
+ * [make] constructs the object the way the generated read does.
+ */
+template <typename T, typename F>
+decltype(auto) load_fixed_layout(uint8_t const* src, F&& make)
+{
+	return load_fixed_layout<T>(src, std::forward<F>(make), std::make_index_sequence<std::tuple_size<T>::value>{});
+}
+
+// endregion
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_FIXED_LAYOUT_H
@@ -0,0 +1,83 @@
+#ifndef RD_CPP_RING_QUEUE_H
+#define RD_CPP_RING_QUEUE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief FIFO queue over a circular array of slots. The array only grows, doubling when full, so once it has reached
+ * the queue's working size pushing and popping don't allocate. Not synchronized, owners guard it with their own lock.
+ */
+template <typename T>
+class ring_queue
+{
+	static constexpr size_t INITIAL_CAPACITY = 64;
+
+	std::vector<T> slots;
+	size_t head = 0;
+	size_t count = 0;
+
+	void grow()
+	{
+		std::vector<T> old = std::move(slots);
+		slots = std::vector<T>(old.empty() ? INITIAL_CAPACITY : old.size() * 2);
+		// capacity is a power of two, so the mask wraps indices
+		const size_t mask = old.size() - 1;
+		for (size_t i = 0; i < count; ++i)
+		{
+			slots[i] = std::move(old[(head + i) & mask]);
+		}
+		head = 0;
+	}
+
+public:
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	void push_back(T value)
+	{
+		if (count == slots.size())
+		{
+			grow();
+		}
+		slots[(head + count) & (slots.size() - 1)] = std::move(value);
+		++count;
+	}
+
+	T pop_front()
+	{
+		T result = std::move(slots[head]);
+		slots[head] = T();
+		head = (head + 1) & (slots.size() - 1);
+		--count;
+		return result;
+	}
+
+	/**
+	 * \brief Removes the last element, work-stealing schedulers let thieves take from this end.
+	 */
+	T pop_back()
+	{
+		const size_t index = (head + count - 1) & (slots.size() - 1);
+		T result = std::move(slots[index]);
+		slots[index] = T();
+		--count;
+		return result;
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_RING_QUEUE_H
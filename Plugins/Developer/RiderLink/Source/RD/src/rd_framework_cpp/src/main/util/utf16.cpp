@@ -0,0 +1,311 @@
+#include "utf16.h"
+
+#include <cstring>
+#include <cwchar>
+
+// the vector kernels load wchar_t as 32-bit lanes, where it's 2 bytes wide (Windows) only the scalar code is built
+#if WCHAR_MAX > 0xFFFF
+
+#if defined(__AVX2__)
+#define RD_UTF16_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RD_UTF16_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RD_UTF16_NEON 1
+#include <arm_neon.h>
+#endif
+
+#endif
+
+// the scalar fallbacks are called from the vector loops, a call there costs more than the conversion itself
+#if defined(_MSC_VER)
+#define RD_UTF16_INLINE __forceinline
+#else
+#define RD_UTF16_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace rd
+{
+namespace util
+{
+namespace
+{
+constexpr uint32_t MAX_BMP = 0xFFFF;
+constexpr uint32_t MAX_CODE_POINT = 0x10FFFF;
+constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+uint16_t load16(uint8_t const* p)
+{
+	uint16_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+uint8_t* store16(uint8_t* p, uint32_t value)
+{
+	const uint16_t unit = static_cast<uint16_t>(value);
+	memcpy(p, &unit, sizeof(unit));
+	return p + sizeof(unit);
+}
+
+bool is_high_surrogate(uint32_t unit)
+{
+	return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+bool is_low_surrogate(uint32_t unit)
+{
+	return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+size_t length_of(uint32_t code_point)
+{
+	return code_point > MAX_BMP && code_point <= MAX_CODE_POINT ? 2 : 1;
+}
+
+RD_UTF16_INLINE uint8_t* narrow(uint8_t* dst, uint32_t code_point)
+{
+	if (code_point <= MAX_BMP)
+	{
+		return store16(dst, code_point);
+	}
+	if (code_point > MAX_CODE_POINT)
+	{
+		return store16(dst, REPLACEMENT_CHARACTER);
+	}
+	code_point -= 0x10000;
+	dst = store16(dst, 0xD800 | (code_point >> 10));
+	return store16(dst, 0xDC00 | (code_point & 0x3FF));
+}
+
+// widens the code point starting at unit [i] of [src], returns the index of the next one
+RD_UTF16_INLINE size_t widen(uint8_t const* src, size_t size, size_t i, wchar_t& code_point)
+{
+	const uint32_t unit = load16(src + 2 * i);
+	if (is_high_surrogate(unit) && i + 1 < size)
+	{
+		const uint32_t next = load16(src + 2 * (i + 1));
+		if (is_low_surrogate(next))
+		{
+			code_point = static_cast<wchar_t>(0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00));
+			return i + 2;
+		}
+	}
+	code_point = static_cast<wchar_t>(unit);
+	return i + 1;
+}
+
+// code point [i] of [src], read through its own type since [src] is a std::wstring buffer
+RD_UTF16_INLINE uint32_t code_point_at(wchar_t const* src, size_t i)
+{
+	return static_cast<uint32_t>(src[i]);
+}
+}	 // namespace
+
+// every kernel handles whole blocks of BMP-only input with vector instructions and falls back to the scalar code
+// for blocks with surrogates and for the tail
+
+size_t utf16_length(wchar_t const* src, size_t size)
+{
+	size_t length = 0;
+	size_t i = 0;
+#if defined(RD_UTF16_AVX2)
+	const __m256i high_mask = _mm256_set1_epi32(static_cast<int>(~MAX_BMP));
+	for (; i + 8 <= size; i += 8)
+	{
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		if (_mm256_testz_si256(v, high_mask))
+		{
+			length += 8;
+			continue;
+		}
+		for (size_t j = i; j < i + 8; ++j)
+		{
+			length += length_of(code_point_at(src, j));
+		}
+	}
+#endif
+#if defined(RD_UTF16_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= size; i += 4)
+	{
+		const __m128i high = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i)), 16);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) == 0xFFFF)
+		{
+			length += 4;
+			continue;
+		}
+		for (size_t j = i; j < i + 4; ++j)
+		{
+			length += length_of(code_point_at(src, j));
+		}
+	}
+#elif defined(RD_UTF16_NEON)
+	for (; i + 4 <= size; i += 4)
+	{
+		if (vmaxvq_u32(vreinterpretq_u32_u8(vld1q_u8(reinterpret_cast<uint8_t const*>(src + i)))) <= MAX_BMP)
+		{
+			length += 4;
+			continue;
+		}
+		for (size_t j = i; j < i + 4; ++j)
+		{
+			length += length_of(code_point_at(src, j));
+		}
+	}
+#endif
+	for (; i < size; ++i)
+	{
+		length += length_of(code_point_at(src, i));
+	}
+	return length;
+}
+
+void utf32_to_utf16(wchar_t const* src, size_t size, uint8_t* dst)
+{
+	size_t i = 0;
+#if defined(RD_UTF16_AVX2)
+	const __m256i high_mask = _mm256_set1_epi32(static_cast<int>(~MAX_BMP));
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m256i a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i + 8));
+		if (!_mm256_testz_si256(_mm256_or_si256(a, b), high_mask))
+		{
+			for (size_t j = i; j < i + 16; ++j)
+			{
+				dst = narrow(dst, code_point_at(src, j));
+			}
+			continue;
+		}
+		// packing works within 128-bit lanes, so the quarters come out as a0 b0 a1 b1
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), packed);
+		dst += 32;
+	}
+#endif
+#if defined(RD_UTF16_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+	for (; i + 8 <= size; i += 8)
+	{
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 4));
+		const __m128i high = _mm_or_si128(_mm_srli_epi32(a, 16), _mm_srli_epi32(b, 16));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF)
+		{
+			for (size_t j = i; j < i + 8; ++j)
+			{
+				dst = narrow(dst, code_point_at(src, j));
+			}
+			continue;
+		}
+		// SSE2 only packs with signed saturation, so the values are shifted into the int16 range and back
+		const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_xor_si128(packed, bias16));
+		dst += 16;
+	}
+#elif defined(RD_UTF16_NEON)
+	for (; i + 8 <= size; i += 8)
+	{
+		const uint32x4_t a = vreinterpretq_u32_u8(vld1q_u8(reinterpret_cast<uint8_t const*>(src + i)));
+		const uint32x4_t b = vreinterpretq_u32_u8(vld1q_u8(reinterpret_cast<uint8_t const*>(src + i + 4)));
+		if (vmaxvq_u32(vorrq_u32(a, b)) > MAX_BMP)
+		{
+			for (size_t j = i; j < i + 8; ++j)
+			{
+				dst = narrow(dst, code_point_at(src, j));
+			}
+			continue;
+		}
+		vst1q_u8(dst, vreinterpretq_u8_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))));
+		dst += 16;
+	}
+#endif
+	for (; i < size; ++i)
+	{
+		dst = narrow(dst, code_point_at(src, i));
+	}
+}
+
+size_t utf16_to_utf32(uint8_t const* src, size_t size, wchar_t* dst)
+{
+	wchar_t* const begin = dst;
+	size_t i = 0;
+#if defined(RD_UTF16_AVX2)
+	const __m256i surrogate_mask = _mm256_set1_epi16(static_cast<short>(0xF800));
+	const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xD800));
+	while (i + 16 <= size)
+	{
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 2 * i));
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(v, surrogate_mask), surrogate)) != 0)
+		{
+			// a pair may straddle the end of the block, so the next block starts where this one stopped
+			const size_t end = i + 16;
+			while (i < end)
+			{
+				i = widen(src, size, i, *dst++);
+			}
+			continue;
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 8), _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)));
+		dst += 16;
+		i += 16;
+	}
+#endif
+#if defined(RD_UTF16_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i surrogate_mask128 = _mm_set1_epi16(static_cast<short>(0xF800));
+	const __m128i surrogate128 = _mm_set1_epi16(static_cast<short>(0xD800));
+	while (i + 8 <= size)
+	{
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 2 * i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, surrogate_mask128), surrogate128)) != 0)
+		{
+			const size_t end = i + 8;
+			while (i < end)
+			{
+				i = widen(src, size, i, *dst++);
+			}
+			continue;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(v, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(v, zero));
+		dst += 8;
+		i += 8;
+	}
+#elif defined(RD_UTF16_NEON)
+	const uint16x8_t surrogate_mask = vdupq_n_u16(0xF800);
+	const uint16x8_t surrogate = vdupq_n_u16(0xD800);
+	while (i + 8 <= size)
+	{
+		const uint16x8_t v = vreinterpretq_u16_u8(vld1q_u8(src + 2 * i));
+		if (vmaxvq_u16(vceqq_u16(vandq_u16(v, surrogate_mask), surrogate)) != 0)
+		{
+			const size_t end = i + 8;
+			while (i < end)
+			{
+				i = widen(src, size, i, *dst++);
+			}
+			continue;
+		}
+		vst1q_u8(reinterpret_cast<uint8_t*>(dst), vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(v))));
+		vst1q_u8(reinterpret_cast<uint8_t*>(dst + 4), vreinterpretq_u8_u32(vmovl_high_u16(v)));
+		dst += 8;
+		i += 8;
+	}
+#endif
+	while (i < size)
+	{
+		i = widen(src, size, i, *dst++);
+	}
+	return static_cast<size_t>(dst - begin);
+}
+}	 // namespace util
+}	 // namespace rd
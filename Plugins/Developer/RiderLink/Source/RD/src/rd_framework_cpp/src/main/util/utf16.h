@@ -0,0 +1,37 @@
+#ifndef RD_CPP_UTF16_H
+#define RD_CPP_UTF16_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Number of UTF-16 code units \ref utf32_to_utf16 produces for [size] code points of [src].
+ * Code points are taken in wchar_t, like std::wstring holds them, which must be 4 bytes wide; where it's 2 bytes wide
+ * strings are already UTF-16 and these functions aren't used.
+ */
+size_t RD_FRAMEWORK_API utf16_length(wchar_t const* src, size_t size);
+
+/**
+ * \brief Narrows [size] code points of [src] into [dst] as native-endian UTF-16, code points above U+FFFF become
+ * surrogate pairs. Values beyond U+10FFFF are replaced with U+FFFD, unpaired surrogates are kept as is.
+ * [dst] may be unaligned and must have room for \ref utf16_length code units.
+ */
+void RD_FRAMEWORK_API utf32_to_utf16(wchar_t const* src, size_t size, uint8_t* dst);
+
+/**
+ * \brief Widens [size] native-endian UTF-16 code units of [src] into [dst], surrogate pairs are combined into
+ * a single code point and unpaired surrogates are kept as is. [src] may be unaligned, [dst] must have room for [size]
+ * code points.
+ * \return number of code points written.
+ */
+size_t RD_FRAMEWORK_API utf16_to_utf32(uint8_t const* src, size_t size, wchar_t* dst);
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_UTF16_H
@@ -7,16 +7,21 @@
 
 namespace rd
 {
-size_t ByteBufferAsyncProcessor::INITIAL_CAPACITY = 1024 * 1024;
+constexpr size_t ByteBufferAsyncProcessor::MAX_BATCH_SIZE_LIMIT;
 
 std::shared_ptr<spdlog::logger> ByteBufferAsyncProcessor::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("byteBufferLog", spdlog::color_mode::automatic);
 
+ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(std::string id, processor_t processor)
+	: ByteBufferAsyncProcessor(std::move(id), std::move(processor), nullptr, 1)
+{
+}
+
 ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(
-	std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor)
-	: id(std::move(id)), processor(std::move(processor))
+	std::string id, processor_t processor, batch_processor_t batch_processor, size_t max_batch_size)
+	: id(std::move(id)), processor(std::move(processor)), batch_processor(std::move(batch_processor))
 {
-	data.reserve(INITIAL_CAPACITY);
+	set_max_batch_size(max_batch_size);
 }
 
 void ByteBufferAsyncProcessor::cleanup0()
@@ -28,7 +33,7 @@ void ByteBufferAsyncProcessor::cleanup0()
 	}
 	// TO-DO clean data
 
-	cv.notify_all();
+	event.notify();
 }
 
 bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set, string_view action)
@@ -50,7 +55,7 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 
 		state = state_to_set;
 	}
-	cv.notify_all();
+	event.notify();
 
 	std::future_status status = async_future.wait_for(timeout);
 
@@ -67,13 +72,10 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 	return success;
 }
 
-void ByteBufferAsyncProcessor::add_data(std::vector<Buffer::ByteArray>&& new_data)
+void ByteBufferAsyncProcessor::add_data()
 {
 	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-	std::move(new_data.begin(), new_data.end(), std::back_inserter(queue));
-	//		for (auto &&item : new_data) {
-	//			queue.emplace(std::move(item));
-	//		}
+	data.drain([this](Buffer::ByteArray&& item) { queue.push_back(std::move(item)); });
 }
 
 bool ByteBufferAsyncProcessor::reprocess()
@@ -88,21 +90,41 @@ bool ByteBufferAsyncProcessor::reprocess()
 
 		logger->debug("{}: reprocessing waited for main processing", id);
 
-		while (current_seqn <= acknowledged_seqn)
+		if (!pending_window.replay(processor))
 		{
-			pending_queue.pop_front();
-			++current_seqn;
+			return false;
 		}
-		for (int i = 0; i < pending_queue.size(); ++i)
+	}
+	return true;
+}
+
+size_t ByteBufferAsyncProcessor::collect_batch()
+{
+	batch.clear();
+	size_t batch_bytes = 0;
+	const size_t limit = batch_processor ? (std::min)(max_batch_size, queue.size()) : 1;
+	for (size_t i = 0; i < limit; ++i)
+	{
+		auto const& item = queue[i];
+		if (!pending_window.has_room(batch_bytes + item.size(), batch.size() + 1))
 		{
-			auto const& item = pending_queue[i];
-			if (!processor(item, current_seqn + i))
-			{
-				return false;
-			}
+			break;
 		}
+		batch_bytes += item.size();
+		batch.push_back(&item);
 	}
-	return true;
+	if (batch.empty())
+	{
+		// publish the flag before the second check, so an acknowledge in between isn't lost
+		backlogged = true;
+		if (!pending_window.has_room(queue.front().size()))
+		{
+			return 0;
+		}
+		backlogged = false;
+		batch.push_back(&queue.front());
+	}
+	return batch.size();
 }
 
 void ByteBufferAsyncProcessor::process()
@@ -114,16 +136,30 @@ void ByteBufferAsyncProcessor::process()
 
 		logger->debug("{}: processing started", id);
 
-		while (!queue.empty() && processor(queue.front(), max_sent_seqn + 1))
+		while (!queue.empty())
 		{
-			++max_sent_seqn;
-			pending_queue.push_back(std::move(queue.front()));
-			queue.pop_front();
+			size_t count = collect_batch();
+			if (count == 0)
+			{
+				logger->debug("{}: retransmit window is full, waiting for acknowledge", id);
+				break;
+			}
+			const bool processed = count == 1 ? processor(queue.front(), max_sent_seqn + 1)
+											  : batch_processor(batch.data(), count, max_sent_seqn + 1);
+			if (!processed)
+			{
+				break;
+			}
+			for (size_t i = 0; i < count; ++i)
+			{
+				++max_sent_seqn;
+				pending_window.push(max_sent_seqn, std::move(queue.front()));
+				queue.pop_front();
+			}
+			queued_count.fetch_sub(count, std::memory_order_relaxed);
 		}
 	}
 	processing_cv.notify_all();
-
-	cv.notify_all();
 }
 
 void ByteBufferAsyncProcessor::ThreadProc()
@@ -134,20 +170,25 @@ void ByteBufferAsyncProcessor::ThreadProc()
 	while (true)
 	{
 		{
-			std::lock_guard<decltype(lock)> guard(lock);
+			// the key is taken before checking the conditions, so a notification in between isn't lost
+			auto key = event.prepare_wait();
+			std::unique_lock<decltype(lock)> guard(lock);
 
 			if (state >= StateKind::Terminated)
 			{
+				event.cancel_wait(key);
 				return;
 			}
 
-			while (data.empty() || interrupt_balance != 0)
+			if ((data.empty() && !backlog_released) || interrupt_balance != 0)
 			{
 				if (state >= StateKind::Stopping)
 				{
+					event.cancel_wait(key);
 					return;
 				}
-				cv.wait(lock);
+				guard.unlock();
+				event.wait(key);
 
 				logger->debug("{}'s ThreadProc waited for notify", id);
 
@@ -155,9 +196,11 @@ void ByteBufferAsyncProcessor::ThreadProc()
 				{
 					return;
 				}
+				continue;
 			}
-			add_data(std::move(data));
-			data.clear();
+			event.cancel_wait(key);
+			backlog_released = false;
+			add_data();
 		}
 
 		try
@@ -200,16 +243,13 @@ bool ByteBufferAsyncProcessor::terminate(time_t timeout)
 
 void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data)
 {
+	if (state >= StateKind::Stopping)
 	{
-		std::lock_guard<decltype(lock)> guard(lock);
-
-		if (state >= StateKind::Stopping)
-		{
-			return;
-		}
-		data.emplace_back(std::move(new_data));
+		return;
 	}
-	cv.notify_all();
+	queued_count.fetch_add(1, std::memory_order_relaxed);
+	data.push(std::move(new_data));
+	event.notify();
 }
 
 void ByteBufferAsyncProcessor::pause(const std::string& reason)
@@ -242,22 +282,62 @@ void ByteBufferAsyncProcessor::resume()
 		logger->debug("{} resumed", id);
 	}
 
-	cv.notify_all();
+	event.notify();
 }
 
 void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 {
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	if (seqn > acknowledged_seqn)
 	{
-		logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
-		acknowledged_seqn = seqn;
-	}
-	else
-	{
-		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+		std::lock_guard<decltype(lock)> guard(lock);
+
+		if (pending_window.acknowledge(seqn))
+		{
+			logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
+		}
+		else
+		{
+			logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn,
+				pending_window.get_acknowledged_seqn());
+			return;
+		}
+
+		if (!backlogged.exchange(false))
+		{
+			return;
+		}
+		backlog_released = true;
 	}
+	event.notify();
+}
+
+void ByteBufferAsyncProcessor::set_retransmit_limits(RetransmitWindow::Limits limits)
+{
+	pending_window.set_limits(limits);
+}
+
+RetransmitWindow::Stats ByteBufferAsyncProcessor::get_retransmit_stats() const
+{
+	return pending_window.get_stats();
+}
+
+size_t ByteBufferAsyncProcessor::get_queue_depth() const
+{
+	return queued_count.load(std::memory_order_relaxed);
+}
+
+bool ByteBufferAsyncProcessor::wait_queue_depth(size_t max_depth, time_t timeout)
+{
+	// [processing_cv] is notified after every pass of [process]
+	std::unique_lock<decltype(processing_lock)> ul(processing_lock);
+	return processing_cv.wait_for(
+		ul, timeout, [this, max_depth]() -> bool { return queued_count.load(std::memory_order_relaxed) <= max_depth; });
+}
+
+void ByteBufferAsyncProcessor::set_max_batch_size(size_t value)
+{
+	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+	max_batch_size = (std::max)(size_t(1), (std::min)(value, MAX_BATCH_SIZE_LIMIT));
+	batch.reserve(max_batch_size);
 }
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state)
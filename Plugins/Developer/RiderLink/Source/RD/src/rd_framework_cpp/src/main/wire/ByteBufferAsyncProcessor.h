@@ -7,6 +7,9 @@
 #endif
 
 #include "protocol/Buffer.h"
+#include "RetransmitWindow.h"
+#include "util/EventCount.h"
+#include "util/MpscQueue.h"
 #include "spdlog/spdlog.h"
 
 #include <chrono>
@@ -15,16 +18,24 @@
 #include <condition_variable>
 #include <future>
 #include <list>
+#include <atomic>
 
 #include <rd_framework_export.h>
 
 namespace rd
 {
-using sequence_number_t = int64_t;
-
 class RD_FRAMEWORK_API ByteBufferAsyncProcessor
 {
 public:
+	using processor_t = std::function<bool(Buffer::ByteArray const&, sequence_number_t seqn)>;
+
+	/**
+	 * \brief Processes [count] consecutive packages starting with [first_seqn] at once, e.g. by a gathered write.
+	 * Must return true only if all of them were processed.
+	 */
+	using batch_processor_t =
+		std::function<bool(Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn)>;
+
 	enum class StateKind
 	{
 		Initialized,
@@ -37,29 +48,41 @@ public:
 private:
 	using time_t = std::chrono::milliseconds;
 
-	static size_t INITIAL_CAPACITY;
+	static constexpr size_t MAX_BATCH_SIZE_LIMIT = 512;
 
 	std::recursive_mutex lock;
-	std::condition_variable_any cv;
+	// wakes up [ThreadProc] on new data and on every change of the state it waits for
+	util::event_count event;
 
 	std::string id;
 
-	std::function<bool(Buffer::ByteArray const&, sequence_number_t seqn)> processor;
+	processor_t processor;
+	batch_processor_t batch_processor;
+
+	size_t max_batch_size = 1;
+	std::vector<Buffer::ByteArray const*> batch;
 
-	StateKind state{StateKind::Initialized};
+	std::atomic<StateKind> state{StateKind::Initialized};
 	static std::shared_ptr<spdlog::logger> logger;
 
 	std::thread::id async_thread_id;
 	std::future<void> async_future;
 
-	std::vector<Buffer::ByteArray> data;
+	// ingress of [put], drained into [queue] by the processing thread only
+	util::mpsc_queue<Buffer::ByteArray> data;
 	std::mutex queue_lock;
 	std::deque<Buffer::ByteArray> queue{};
-	std::deque<Buffer::ByteArray> pending_queue{};
+	// packages put but not processed yet, both in [data] and [queue]
+	std::atomic<size_t> queued_count{0};
+	RetransmitWindow pending_window;
 
 	sequence_number_t max_sent_seqn = 0;
-	sequence_number_t current_seqn = 1;
-	sequence_number_t acknowledged_seqn = 0;
+
+	/**
+	 * \brief Set when processing stopped because [pending_window] is full, cleared once an acknowledge releases it.
+	 */
+	std::atomic<bool> backlogged{false};
+	bool backlog_released = false;
 
 	int32_t interrupt_balance = 0;
 	bool in_processing = false;
@@ -69,7 +92,9 @@ private:
 public:
 	// region ctor/dtor
 
-	explicit ByteBufferAsyncProcessor(std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor);
+	explicit ByteBufferAsyncProcessor(std::string id, processor_t processor);
+
+	ByteBufferAsyncProcessor(std::string id, processor_t processor, batch_processor_t batch_processor, size_t max_batch_size);
 
 	// endregion
 private:
@@ -77,10 +102,12 @@ private:
 
 	bool terminate0(time_t timeout, StateKind state_to_set, string_view action);
 
-	void add_data(std::vector<Buffer::ByteArray>&& new_data);
+	void add_data();
 
 	bool reprocess();
 
+	size_t collect_batch();
+
 	void process();
 
 	void ThreadProc();
@@ -92,6 +119,9 @@ public:
 
 	bool terminate(time_t timeout = time_t(0) /*InfiniteDuration*/);
 
+	/**
+	 * \brief Enqueues [new_data] for processing. Lock-free, may be called from any thread.
+	 */
 	void put(Buffer::ByteArray new_data);
 
 	void pause(const std::string& reason);
@@ -99,6 +129,31 @@ public:
 	void resume();
 
 	void acknowledge(int64_t seqn);
+
+	/**
+	 * \brief Bounds the amount of sent but not yet acknowledged data. Processing of the queue is suspended while
+	 * the bound is exceeded.
+	 */
+	void set_retransmit_limits(RetransmitWindow::Limits limits);
+
+	RetransmitWindow::Stats get_retransmit_stats() const;
+
+	/**
+	 * \brief Number of packages put but not processed yet. Lock-free.
+	 */
+	size_t get_queue_depth() const;
+
+	/**
+	 * \brief Blocks until at most [max_depth] packages are queued or [timeout] elapses.
+	 * \return true if the queue has drained to [max_depth].
+	 */
+	bool wait_queue_depth(size_t max_depth, time_t timeout);
+
+	/**
+	 * \brief Sets the maximum number of queued packages handed to the batch processor at once.
+	 * 1 disables batching, the limit has no effect if no batch processor was provided.
+	 */
+	void set_max_batch_size(size_t value);
 };
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state);
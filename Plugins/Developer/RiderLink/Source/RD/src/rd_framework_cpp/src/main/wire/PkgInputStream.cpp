@@ -8,32 +8,28 @@ namespace rd
 {
 void PkgInputStream::rewind()
 {
-	buffer.rewind();
+	position = 0;
 }
 
 void PkgInputStream::require_available(int size)
 {
-	buffer.require_available(size);
+	// views of the previous package may still be alive, the chunk takes care of not overwriting them
+	chunk.reset(static_cast<size_t>(size));
 }
 
 size_t PkgInputStream::get_position() const
 {
-	return buffer.get_position();
+	return position;
 }
 
 Buffer::word_t* PkgInputStream::data()
 {
-	return buffer.data();
-}
-
-Buffer& PkgInputStream::get_buffer()
-{
-	return buffer;
+	return chunk.data();
 }
 
 int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
 {
-	if (memory == -1 || buffer.get_position() == memory)
+	if (memory == -1 || position == memory)
 	{
 		memory = request_data();
 		if (memory == -1)
@@ -41,16 +37,16 @@ int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
 			return -1;
 		}
 	}
-	const int32_t n = static_cast<int32_t>((std::min)(size, memory - buffer.get_position()));
-	Buffer::word_t* start = buffer.current_pointer();
+	const int32_t n = static_cast<int32_t>((std::min)(size, memory - position));
+	Buffer::word_t const* start = chunk.data() + position;
 	std::copy(start, start + n, res);
-	buffer.set_position(buffer.get_position() + n);
+	position += n;
 	return n;
 }
 
 bool PkgInputStream::read(Buffer::word_t* res, size_t size)
 {
-	//		spdlog::trace("PkgInputStream call: size={}, pos={}, memory={}", size, buffer.get_position(), memory);
+	//		spdlog::trace("PkgInputStream call: size={}, pos={}, memory={}", size, position, memory);
 
 	int32_t summary_size = 0;
 	while (summary_size < size)
@@ -64,4 +60,15 @@ bool PkgInputStream::read(Buffer::word_t* res, size_t size)
 	}
 	return true;
 }
+
+optional<Buffer> PkgInputStream::try_read_view(int32_t size)
+{
+	if (size < 0 || memory == static_cast<size_t>(-1) || position > memory || memory - position < static_cast<size_t>(size))
+	{
+		return nullopt;
+	}
+	Buffer result(chunk, position, static_cast<size_t>(size));
+	position += static_cast<size_t>(size);
+	return make_optional<Buffer>(std::move(result));
+}
 }	 // namespace rd
@@ -7,6 +7,7 @@
 #endif
 
 #include "protocol/Buffer.h"
+#include "protocol/SharedChunk.h"
 
 #include <rd_framework_export.h>
 
@@ -15,7 +16,9 @@ namespace rd
 class RD_FRAMEWORK_API PkgInputStream
 {
 private:
-	Buffer buffer;
+	SharedChunk chunk;
+
+	size_t position = 0;
 
 	std::function<int32_t()> request_data;
 
@@ -35,12 +38,17 @@ public:
 
 	Buffer::word_t* data();
 
-	Buffer& get_buffer();
-
 	int32_t try_read(Buffer::word_t* res, size_t size);
 
 	bool read(Buffer::word_t* res, size_t size);
 
+	/**
+	 * \brief Returns a view over the next [size] bytes without copying them if they lie within the current package.
+	 * Returns nullopt (and consumes nothing) otherwise or for a negative [size], in that case bytes should be read with
+	 * \ref read.
+	 */
+	optional<Buffer> try_read_view(int32_t size);
+
 	template <typename T>
 	T read_integral()
 	{
@@ -0,0 +1,304 @@
+#include "Reactor.h"
+
+#if defined(__linux__)
+
+#include <util/thread_util.h>
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace rd
+{
+std::shared_ptr<spdlog::logger> Reactor::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("reactorLog", spdlog::color_mode::automatic);
+
+static constexpr int MAX_EVENTS = 64;
+
+Reactor::Reactor(Lifetime lifetime, std::string name) : name(std::move(name)), lifetime_definition(lifetime)
+{
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	RD_ASSERT_THROW_MSG(epoll_fd != -1, this->name + ": failed to create epoll, reason: " + std::strerror(errno));
+	wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	RD_ASSERT_THROW_MSG(wakeup_fd != -1, this->name + ": failed to create eventfd, reason: " + std::strerror(errno));
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = wakeup_fd;
+	RD_ASSERT_THROW_MSG(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &event) == 0,
+		this->name + ": failed to watch eventfd, reason: " + std::strerror(errno));
+
+	{
+		// run() takes the lock before it looks at anything, so it sees thread_id set
+		std::lock_guard<decltype(tasks_lock)> guard(tasks_lock);
+		thread = std::thread([this] { run(); });
+		thread_id = thread.get_id();
+	}
+
+	lifetime_definition.lifetime->add_action([this] { stop(); });
+}
+
+Reactor::~Reactor()
+{
+	// the thread can't join itself, and it mustn't outlive the descriptors and handlers it runs on
+	RD_ASSERT_MSG(!is_reactor_thread(), name + ": destroyed from its own thread");
+	if (!lifetime_definition.is_terminated())
+	{
+		lifetime_definition.terminate();
+	}
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+	close(wakeup_fd);
+	close(epoll_fd);
+}
+
+void Reactor::stop()
+{
+	{
+		std::lock_guard<decltype(tasks_lock)> guard(tasks_lock);
+		stopped = true;
+	}
+	wakeup();
+
+	// stopped by a task or a handler, the loop exits after it and the destructor joins the thread
+	if (!is_reactor_thread() && thread.joinable())
+	{
+		thread.join();
+	}
+	logger->debug("{}: stopped", name);
+}
+
+void Reactor::wakeup() const
+{
+	uint64_t one = 1;
+	if (write(wakeup_fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN)
+	{
+		logger->error("{}: failed to wake up, reason: {}", name, std::strerror(errno));
+	}
+}
+
+bool Reactor::post(task_t task)
+{
+	{
+		std::lock_guard<decltype(tasks_lock)> guard(tasks_lock);
+		if (stopped)
+		{
+			return false;
+		}
+		tasks.push_back(std::move(task));
+	}
+	wakeup();
+	return true;
+}
+
+void Reactor::invoke_or_post(task_t task)
+{
+	if (is_reactor_thread())
+	{
+		task();
+	}
+	else
+	{
+		post(std::move(task));
+	}
+}
+
+bool Reactor::is_reactor_thread() const
+{
+	return thread_id == std::this_thread::get_id();
+}
+
+bool Reactor::add(int fd, uint32_t events, handler_t handler)
+{
+	epoll_event event{};
+	event.events = events;
+	event.data.fd = fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		logger->error("{}: failed to watch fd {}, reason: {}", name, fd, std::strerror(errno));
+		return false;
+	}
+	handlers[fd] = std::make_shared<handler_t>(std::move(handler));
+	return true;
+}
+
+bool Reactor::modify(int fd, uint32_t events)
+{
+	epoll_event event{};
+	event.events = events;
+	event.data.fd = fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) != 0)
+	{
+		logger->error("{}: failed to modify fd {}, reason: {}", name, fd, std::strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+void Reactor::remove(int fd)
+{
+	if (handlers.erase(fd) > 0)
+	{
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	}
+}
+
+Reactor::timer_id_t Reactor::schedule(std::chrono::milliseconds delay, task_t action, std::chrono::milliseconds period)
+{
+	const timer_id_t id = next_timer_id++;
+	const auto deadline = clock_t::now() + delay;
+	timers.emplace(id, Timer{deadline, period, std::move(action)});
+	deadlines.emplace(deadline, id);
+	return id;
+}
+
+void Reactor::cancel(timer_id_t id)
+{
+	auto it = timers.find(id);
+	if (it == timers.end())
+	{
+		return;
+	}
+	auto range = deadlines.equal_range(it->second.deadline);
+	for (auto d = range.first; d != range.second; ++d)
+	{
+		if (d->second == id)
+		{
+			deadlines.erase(d);
+			break;
+		}
+	}
+	timers.erase(it);
+}
+
+void Reactor::run_tasks()
+{
+	std::vector<task_t> current;
+	{
+		std::lock_guard<decltype(tasks_lock)> guard(tasks_lock);
+		current.swap(tasks);
+	}
+	for (auto& task : current)
+	{
+		try
+		{
+			task();
+		}
+		catch (std::exception const& e)
+		{
+			logger->error("{}: task failed | {}", name, e.what());
+		}
+	}
+}
+
+int Reactor::run_timers()
+{
+	const auto now = clock_t::now();
+	while (!deadlines.empty() && deadlines.begin()->first <= now)
+	{
+		const timer_id_t id = deadlines.begin()->second;
+		deadlines.erase(deadlines.begin());
+
+		auto it = timers.find(id);
+		if (it == timers.end())
+		{
+			continue;
+		}
+		task_t action = it->second.action;
+		if (it->second.period.count() > 0)
+		{
+			it->second.deadline = now + it->second.period;
+			deadlines.emplace(it->second.deadline, id);
+		}
+		else
+		{
+			timers.erase(it);
+		}
+
+		try
+		{
+			action();
+		}
+		catch (std::exception const& e)
+		{
+			logger->error("{}: timer failed | {}", name, e.what());
+		}
+	}
+	if (deadlines.empty())
+	{
+		return -1;
+	}
+	const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadlines.begin()->first - clock_t::now());
+	return static_cast<int>((std::max)(wait.count() + 1, decltype(wait.count())(0)));
+}
+
+void Reactor::run()
+{
+	rd::util::set_thread_name(name.c_str());
+
+	logger->debug("{}: started", name);
+
+	epoll_event events[MAX_EVENTS];
+	while (true)
+	{
+		{
+			std::lock_guard<decltype(tasks_lock)> guard(tasks_lock);
+			if (stopped)
+			{
+				break;
+			}
+		}
+
+		const int timeout = run_timers();
+		const int n = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout);
+		if (n == -1 && errno != EINTR)
+		{
+			logger->error("{}: epoll_wait failed, reason: {}", name, std::strerror(errno));
+			break;
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			const int fd = events[i].data.fd;
+			if (fd == wakeup_fd)
+			{
+				uint64_t value;
+				while (read(wakeup_fd, &value, sizeof(value)) > 0)
+				{
+				}
+				continue;
+			}
+			auto it = handlers.find(fd);
+			if (it == handlers.end())
+			{
+				continue;
+			}
+			// keep the handler alive even if it removes itself
+			const auto handler = it->second;
+			try
+			{
+				(*handler)(events[i].events);
+			}
+			catch (std::exception const& e)
+			{
+				logger->error("{}: handler of fd {} failed | {}", name, fd, e.what());
+			}
+		}
+
+		run_tasks();
+	}
+	// tasks accepted before stop are guaranteed to be executed
+	run_tasks();
+
+	logger->debug("{}: finished", name);
+}
+}	 // namespace rd
+
+#endif	  // __linux__
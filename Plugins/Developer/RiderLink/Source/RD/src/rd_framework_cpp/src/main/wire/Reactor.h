@@ -0,0 +1,128 @@
+#ifndef RD_CPP_REACTOR_H
+#define RD_CPP_REACTOR_H
+
+#if defined(__linux__)
+
+#include "lifetime/LifetimeDefinition.h"
+#include "util/core_util.h"
+#include "spdlog/spdlog.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Event loop multiplexing readiness of many file descriptors (epoll) and timers on a single thread.
+ * Used by ReactorWire so that N connections cost O(1) threads.
+ */
+class RD_FRAMEWORK_API Reactor
+{
+public:
+	using handler_t = std::function<void(uint32_t events)>;
+
+	using task_t = std::function<void()>;
+
+	using timer_id_t = uint64_t;
+
+	using clock_t = std::chrono::steady_clock;
+
+private:
+	struct Timer
+	{
+		clock_t::time_point deadline;
+		std::chrono::milliseconds period;
+		task_t action;
+	};
+
+	static std::shared_ptr<spdlog::logger> logger;
+
+	std::string name;
+
+	int epoll_fd = -1;
+	int wakeup_fd = -1;
+
+	std::thread thread;
+	// written by the constructor only, before the thread looks at it
+	std::thread::id thread_id;
+
+	bool stopped = false;
+
+	std::mutex tasks_lock;
+	std::vector<task_t> tasks;
+
+	// accessed on the reactor thread only
+	std::unordered_map<int, std::shared_ptr<handler_t>> handlers;
+	timer_id_t next_timer_id = 1;
+	std::unordered_map<timer_id_t, Timer> timers;
+	std::multimap<clock_t::time_point, timer_id_t> deadlines;
+
+	LifetimeDefinition lifetime_definition;
+
+	void run();
+
+	void wakeup() const;
+
+	void run_tasks();
+
+	int run_timers();
+
+	void stop();
+
+public:
+	// region ctor/dtor
+
+	Reactor(Lifetime lifetime, std::string name = "Reactor");
+
+	Reactor(Reactor const&) = delete;
+
+	Reactor& operator=(Reactor const&) = delete;
+
+	virtual ~Reactor();
+	// endregion
+
+	/**
+	 * \brief Queues [task] to be executed on the reactor thread. Thread-safe.
+	 * \return false if the reactor is already stopped and [task] will never be executed.
+	 */
+	bool post(task_t task);
+
+	/**
+	 * \brief Executes [task] immediately if called on the reactor thread, posts it otherwise.
+	 */
+	void invoke_or_post(task_t task);
+
+	bool is_reactor_thread() const;
+
+	/**
+	 * \brief Starts watching [fd] for [events] (EPOLLIN, EPOLLOUT...). Must be called on the reactor thread.
+	 */
+	bool add(int fd, uint32_t events, handler_t handler);
+
+	bool modify(int fd, uint32_t events);
+
+	void remove(int fd);
+
+	/**
+	 * \brief Executes [action] on the reactor thread after [delay], then every [period] if it's non-zero.
+	 * Must be called on the reactor thread.
+	 */
+	timer_id_t schedule(std::chrono::milliseconds delay, task_t action, std::chrono::milliseconds period = {});
+
+	void cancel(timer_id_t id);
+};
+}	 // namespace rd
+
+#endif	  // __linux__
+
+#endif	  // RD_CPP_REACTOR_H
@@ -0,0 +1,606 @@
+#include "wire/ReactorWire.h"
+
+#if defined(__linux__)
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <future>
+
+namespace rd
+{
+std::shared_ptr<spdlog::logger> ReactorWire::Base::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("reactorWireLog", spdlog::color_mode::automatic);
+
+std::chrono::milliseconds ReactorWire::timeout = std::chrono::milliseconds(500);
+
+constexpr int32_t ReactorWire::Base::ACK_MESSAGE_LENGTH;
+constexpr int32_t ReactorWire::Base::PING_MESSAGE_LENGTH;
+constexpr int32_t ReactorWire::Base::PACKAGE_HEADER_LENGTH;
+constexpr int32_t ReactorWire::Base::MESSAGE_HEADER_LENGTH;
+constexpr size_t ReactorWire::Base::RECEIVE_BUFFER_SIZE;
+
+static bool set_no_delay(int fd)
+{
+	int one = 1;
+	return setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == 0;
+}
+
+ReactorWire::Base::Base(std::string id, IScheduler* scheduler, Reactor* reactor)
+	: WireBase(scheduler), id(std::move(id)), reactor(reactor)
+{
+}
+
+void ReactorWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const
+{
+	Buffer::ByteArray package = write_message(rd_id, writer, size_hint);
+
+	std::lock_guard<decltype(send_lock)> guard(send_lock);
+	if (terminated)
+	{
+		logger->debug("{}: message {} is dropped, wire is terminated", this->id, rd_id.get_hash());
+		return;
+	}
+	outgoing.push_back(std::move(package));
+	// messages queued before the flush runs go out within the same write
+	if (!flush_scheduled)
+	{
+		flush_scheduled = true;
+		auto self = const_cast<Base*>(this);
+		reactor->post([self] { self->flush(); });
+	}
+}
+
+void ReactorWire::Base::flush()
+{
+	std::vector<Buffer::ByteArray> batch;
+	{
+		std::lock_guard<decltype(send_lock)> guard(send_lock);
+		batch.swap(outgoing);
+		flush_scheduled = false;
+	}
+	for (auto& package : batch)
+	{
+		const sequence_number_t seqn = next_seqn++;
+		if (fd != -1)
+		{
+			append_package(package, seqn);
+		}
+		window.push(seqn, std::move(package));
+	}
+	write_output();
+}
+
+void ReactorWire::Base::append_package(Buffer::ByteArray const& package, sequence_number_t seqn)
+{
+	append_integral(static_cast<int32_t>(package.size()));
+	append_integral(seqn);
+	output.insert(output.end(), package.begin(), package.end());
+}
+
+void ReactorWire::Base::write_output()
+{
+	if (fd == -1)
+	{
+		output.clear();
+		output_position = 0;
+		return;
+	}
+	while (output_position < output.size())
+	{
+		const ssize_t sent = ::send(fd, output.data() + output_position, output.size() - output_position, MSG_NOSIGNAL);
+		if (sent > 0)
+		{
+			output_position += static_cast<size_t>(sent);
+			continue;
+		}
+		if (sent == -1 && errno == EINTR)
+		{
+			continue;
+		}
+		if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			if (!want_write)
+			{
+				want_write = true;
+				reactor->modify(fd, EPOLLIN | EPOLLOUT);
+			}
+			// keep the unsent tail only
+			if (output_position >= RECEIVE_BUFFER_SIZE)
+			{
+				output.erase(output.begin(), output.begin() + output_position);
+				output_position = 0;
+			}
+			return;
+		}
+		logger->debug("{}: failed to send over the network, reason: {}", this->id, std::strerror(errno));
+		detach();
+		return;
+	}
+	output.clear();
+	output_position = 0;
+	if (want_write)
+	{
+		want_write = false;
+		reactor->modify(fd, EPOLLIN);
+	}
+}
+
+void ReactorWire::Base::on_readable()
+{
+	while (fd != -1)
+	{
+		const size_t old_size = input.size();
+		input.resize(old_size + RECEIVE_BUFFER_SIZE);
+		const ssize_t read = ::recv(fd, input.data() + old_size, RECEIVE_BUFFER_SIZE, 0);
+		input.resize(old_size + (read > 0 ? static_cast<size_t>(read) : 0));
+		if (read > 0)
+		{
+			logger->trace("{}: receive finished: {} bytes read", this->id, read);
+			try
+			{
+				parse_input();
+			}
+			catch (std::exception const& e)
+			{
+				logger->error("{} caught processing | {}", this->id, e.what());
+				detach();
+				return;
+			}
+			continue;
+		}
+		if (read == -1 && errno == EINTR)
+		{
+			continue;
+		}
+		if (read == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		if (read == 0)
+		{
+			logger->debug("{}: connection was gracefully shutdown", this->id);
+		}
+		else
+		{
+			logger->debug("{}: error has occurred while receiving, reason: {}", this->id, std::strerror(errno));
+		}
+		detach();
+		return;
+	}
+	// acknowledges of the received packages
+	write_output();
+}
+
+void ReactorWire::Base::parse_input()
+{
+	while (fd != -1)
+	{
+		const size_t available = input.size() - input_position;
+		Buffer::word_t const* data = input.data() + input_position;
+		if (available < sizeof(int32_t))
+		{
+			break;
+		}
+		int32_t len;
+		std::memcpy(&len, data, sizeof(len));
+		if (len == PING_MESSAGE_LENGTH)
+		{
+			if (available < PACKAGE_HEADER_LENGTH)
+			{
+				break;
+			}
+			std::memcpy(&counterpart_timestamp, data + sizeof(int32_t), sizeof(int32_t));
+			std::memcpy(&counterpart_acknowledge_timestamp, data + 2 * sizeof(int32_t), sizeof(int32_t));
+			input_position += PACKAGE_HEADER_LENGTH;
+			if (connection_established(current_timestamp, counterpart_acknowledge_timestamp))
+			{
+				heartbeatAlive.set(true);
+			}
+			continue;
+		}
+		if (available < PACKAGE_HEADER_LENGTH)
+		{
+			break;
+		}
+		sequence_number_t seqn;
+		std::memcpy(&seqn, data + sizeof(int32_t), sizeof(seqn));
+		if (len == ACK_MESSAGE_LENGTH)
+		{
+			window.acknowledge(seqn);
+			input_position += PACKAGE_HEADER_LENGTH;
+			continue;
+		}
+		RD_ASSERT_THROW_MSG(len >= 0, fmt::format("{}: invalid package length {}", this->id, len));
+		if (available < PACKAGE_HEADER_LENGTH + static_cast<size_t>(len))
+		{
+			break;
+		}
+		input_position += PACKAGE_HEADER_LENGTH + len;
+
+		append_integral(ACK_MESSAGE_LENGTH);
+		append_integral(seqn);
+		if (seqn <= max_received_seqn && seqn != 1)
+		{
+			// already received before reconnect, skip it
+			continue;
+		}
+		max_received_seqn = seqn;
+		logger->trace("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+		receive_package(data + PACKAGE_HEADER_LENGTH, len);
+	}
+
+	if (input_position == input.size())
+	{
+		input.clear();
+		input_position = 0;
+	}
+	else if (input_position > 0)
+	{
+		input.erase(input.begin(), input.begin() + input_position);
+		input_position = 0;
+	}
+}
+
+void ReactorWire::Base::receive_package(Buffer::word_t const* data, int32_t len)
+{
+	chunk.reset(len);
+	std::memcpy(chunk.data(), data, len);
+
+	// the messages of the package are handed over to the scheduler at once
+	MessageBroker::BatchGuard batch_guard(message_broker);
+	int32_t position = 0;
+	while (position < len)
+	{
+		if (message_rest == -1)
+		{
+			const int32_t header_part = (std::min)(MESSAGE_HEADER_LENGTH - message_header_filled, len - position);
+			std::memcpy(message_header.data() + message_header_filled, chunk.data() + position, header_part);
+			message_header_filled += header_part;
+			position += header_part;
+			if (message_header_filled < MESSAGE_HEADER_LENGTH)
+			{
+				break;
+			}
+			int32_t sz;
+			std::memcpy(&sz, message_header.data(), sizeof(sz));
+			std::memcpy(&message_id, message_header.data() + sizeof(sz), sizeof(message_id));
+			message_header_filled = 0;
+			message_rest = sz - static_cast<int32_t>(sizeof(RdId::hash_t));
+			RD_ASSERT_THROW_MSG(message_rest >= 0, fmt::format("{}: invalid message size {}", this->id, sz));
+
+			// a message which lies within a single package is dispatched as a view over it, otherwise it's assembled
+			if (message_rest <= len - position)
+			{
+				dispatch_message(Buffer(chunk, position, message_rest));
+				position += message_rest;
+				message_rest = -1;
+				continue;
+			}
+			message = Buffer(message_rest);
+			message_filled = 0;
+		}
+		const int32_t part = (std::min)(message_rest - message_filled, len - position);
+		std::memcpy(message.data() + message_filled, chunk.data() + position, part);
+		message_filled += part;
+		position += part;
+		if (message_filled == message_rest)
+		{
+			message_rest = -1;
+			dispatch_message(std::move(message));
+		}
+	}
+}
+
+void ReactorWire::Base::dispatch_message(Buffer msg)
+{
+	logger->trace("{}: message info: id={}", this->id, message_id);
+	message_broker.dispatch(RdId{message_id}, std::move(msg));
+}
+
+bool ReactorWire::Base::connection_established(int32_t timestamp, int32_t acknowledged_timestamp)
+{
+	return timestamp - acknowledged_timestamp <= MaximumHeartbeatDelay;
+}
+
+void ReactorWire::Base::ping()
+{
+	if (!connection_established(current_timestamp, counterpart_acknowledge_timestamp))
+	{
+		if (heartbeatAlive.get())
+		{	 // only on change
+			logger->trace(
+				"Disconnect detected while sending PING {}: "
+				"current_timestamp: {}, "
+				"counterpart_timestamp: {}, "
+				"counterpart_acknowledge_timestamp: {}",
+				this->id, current_timestamp, counterpart_timestamp, counterpart_acknowledge_timestamp);
+		}
+		heartbeatAlive.set(false);
+	}
+	append_integral(PING_MESSAGE_LENGTH);
+	append_integral(current_timestamp);
+	append_integral(counterpart_timestamp);
+	write_output();
+
+	++current_timestamp;
+}
+
+void ReactorWire::Base::attach(int new_fd)
+{
+	fd = new_fd;
+	want_write = false;
+	output.clear();
+	output_position = 0;
+	input.clear();
+	input_position = 0;
+	if (!set_no_delay(fd))
+	{
+		logger->warn("{}: tcpNoDelay failed, reason: {}", this->id, std::strerror(errno));
+	}
+	if (!reactor->add(fd, EPOLLIN, [this](uint32_t events) {
+			if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			{
+				on_readable();
+			}
+			if (fd != -1 && (events & EPOLLOUT))
+			{
+				write_output();
+			}
+		}))
+	{
+		::close(fd);
+		fd = -1;
+		on_disconnected();
+		return;
+	}
+
+	window.replay([this](Buffer::ByteArray const& package, sequence_number_t seqn) {
+		append_package(package, seqn);
+		return true;
+	});
+	heartbeat_timer = reactor->schedule(heartBeatInterval, [this] { ping(); }, heartBeatInterval);
+
+	connected.set(true);
+
+	write_output();
+}
+
+void ReactorWire::Base::detach()
+{
+	if (fd == -1)
+	{
+		return;
+	}
+	reactor->cancel(heartbeat_timer);
+	heartbeat_timer = 0;
+	reactor->remove(fd);
+	::close(fd);
+	fd = -1;
+	output.clear();
+	output_position = 0;
+
+	connected.set(false);
+
+	on_disconnected();
+}
+
+void ReactorWire::Base::close()
+{
+	if (fd == -1)
+	{
+		return;
+	}
+	reactor->cancel(heartbeat_timer);
+	reactor->remove(fd);
+	::close(fd);
+	fd = -1;
+}
+
+void ReactorWire::Base::terminate()
+{
+	{
+		std::lock_guard<decltype(send_lock)> guard(send_lock);
+		terminated = true;
+	}
+	if (reactor->is_reactor_thread())
+	{
+		close();
+		return;
+	}
+	std::promise<void> closed;
+	if (reactor->post([this, &closed] {
+			close();
+			closed.set_value();
+		}))
+	{
+		closed.get_future().wait();
+	}
+	else
+	{
+		// the reactor thread is gone, nobody else touches the wire
+		close();
+	}
+}
+
+RetransmitWindow::Stats ReactorWire::Base::get_retransmit_stats() const
+{
+	return window.get_stats();
+}
+
+ReactorWire::Client::Client(
+	Lifetime parentLifetime, IScheduler* scheduler, Reactor* reactor, uint16_t port, const std::string& id)
+	: Base(id, scheduler, reactor), port(port), clientLifetimeDefinition(parentLifetime)
+{
+	logger->info("{}: started, port: {}.", this->id, this->port);
+
+	reactor->post([this] { connect(); });
+
+	clientLifetimeDefinition.lifetime->add_action([this] {
+		logger->info("{}: starts terminating lifetime", this->id);
+		terminate();
+		logger->info("{}: termination finished", this->id);
+	});
+}
+
+ReactorWire::Client::~Client()
+{
+	if (!clientLifetimeDefinition.is_terminated())
+	{
+		clientLifetimeDefinition.terminate();
+	}
+}
+
+void ReactorWire::Client::connect()
+{
+	reconnect_timer = 0;
+
+	const int new_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (new_fd == -1)
+	{
+		logger->error("{}: failed to create socket, reason: {}", this->id, std::strerror(errno));
+		on_disconnected();
+		return;
+	}
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
+	if (::connect(new_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+	{
+		attach(new_fd);
+		return;
+	}
+	if (errno != EINPROGRESS)
+	{
+		logger->debug("{}: connection error for port {} ({}).", this->id, this->port, std::strerror(errno));
+		::close(new_fd);
+		on_disconnected();
+		return;
+	}
+	connecting_fd = new_fd;
+	reactor->add(new_fd, EPOLLOUT, [this, new_fd](uint32_t) {
+		// the connection handler is replaced by the regular one in attach
+		reactor->remove(new_fd);
+		connecting_fd = -1;
+		on_connect_result(new_fd);
+	});
+}
+
+void ReactorWire::Client::on_connect_result(int new_fd)
+{
+	int error = 0;
+	socklen_t length = sizeof(error);
+	if (getsockopt(new_fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0)
+	{
+		logger->debug("{}: connection error for port {} ({}).", this->id, this->port, std::strerror(error));
+		::close(new_fd);
+		on_disconnected();
+		return;
+	}
+	attach(new_fd);
+}
+
+void ReactorWire::Client::on_disconnected()
+{
+	reconnect_timer = reactor->schedule(timeout, [this] { connect(); });
+}
+
+void ReactorWire::Client::close()
+{
+	if (reconnect_timer != 0)
+	{
+		reactor->cancel(reconnect_timer);
+		reconnect_timer = 0;
+	}
+	if (connecting_fd != -1)
+	{
+		reactor->remove(connecting_fd);
+		::close(connecting_fd);
+		connecting_fd = -1;
+	}
+	Base::close();
+}
+
+ReactorWire::Server::Server(
+	Lifetime parentLifetime, IScheduler* scheduler, Reactor* reactor, uint16_t port, const std::string& id)
+	: Base(id, scheduler, reactor), serverLifetimeDefinition(parentLifetime)
+{
+	listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	RD_ASSERT_THROW_MSG(listen_fd != -1, fmt::format("{}: failed to initialize socket, reason: {}", this->id, std::strerror(errno)));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(address);
+	RD_ASSERT_THROW_MSG(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), length) == 0 && ::listen(listen_fd, 1) == 0 &&
+							::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &length) == 0,
+		fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, port, std::strerror(errno)));
+
+	this->port = ntohs(address.sin_port);
+	logger->info("{}: listening 127.0.0.1/{}", this->id, this->port);
+
+	reactor->post([this] { this->reactor->add(listen_fd, EPOLLIN, [this](uint32_t) { accept(); }); });
+
+	serverLifetimeDefinition.lifetime->add_action([this] {
+		logger->info("{}: start terminating lifetime", this->id);
+		terminate();
+		logger->info("{}: termination finished", this->id);
+	});
+}
+
+ReactorWire::Server::~Server()
+{
+	if (!serverLifetimeDefinition.is_terminated())
+	{
+		serverLifetimeDefinition.terminate();
+	}
+}
+
+void ReactorWire::Server::accept()
+{
+	const int new_fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (new_fd == -1)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			logger->info("{}: accepting failed, reason: {}", this->id, std::strerror(errno));
+		}
+		return;
+	}
+	logger->info("{}: accepted passive socket", this->id);
+	// a single connection is served at a time, stop accepting until it's lost
+	reactor->modify(listen_fd, 0);
+	attach(new_fd);
+}
+
+void ReactorWire::Server::on_disconnected()
+{
+	reactor->modify(listen_fd, EPOLLIN);
+}
+
+void ReactorWire::Server::close()
+{
+	Base::close();
+	if (listen_fd != -1)
+	{
+		reactor->remove(listen_fd);
+		::close(listen_fd);
+		listen_fd = -1;
+	}
+}
+}	 // namespace rd
+
+#endif	  // __linux__
@@ -0,0 +1,213 @@
+#ifndef RD_CPP_REACTORWIRE_H
+#define RD_CPP_REACTORWIRE_H
+
+#if defined(__linux__)
+
+#include "base/WireBase.h"
+#include "protocol/SharedChunk.h"
+#include "Reactor.h"
+#include "RetransmitWindow.h"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Socket wire driven by a shared Reactor instead of dedicated receiver, sender and heartbeat threads.
+ * Uses the same framing, acknowledges and heartbeat as SocketWire, so either side may be replaced by SocketWire.
+ * The reactor must outlive all wires attached to it.
+ */
+class RD_FRAMEWORK_API ReactorWire
+{
+	static std::chrono::milliseconds timeout;
+
+public:
+	class RD_FRAMEWORK_API Base : public WireBase
+	{
+	protected:
+		static std::shared_ptr<spdlog::logger> logger;
+
+		std::string id;
+		Reactor* reactor = nullptr;
+
+		static constexpr int32_t ACK_MESSAGE_LENGTH = -1;
+		static constexpr int32_t PING_MESSAGE_LENGTH = -2;
+		static constexpr int32_t PACKAGE_HEADER_LENGTH = sizeof(ACK_MESSAGE_LENGTH) + sizeof(sequence_number_t);
+		static constexpr int32_t MESSAGE_HEADER_LENGTH = sizeof(int32_t) + sizeof(RdId::hash_t);
+		static constexpr size_t RECEIVE_BUFFER_SIZE = 1u << 16;
+
+		// guards messages queued by [send] from arbitrary threads
+		mutable std::mutex send_lock;
+		mutable std::vector<Buffer::ByteArray> outgoing;
+		mutable bool flush_scheduled = false;
+		bool terminated = false;
+
+		// everything below is accessed on the reactor thread only
+		int fd = -1;
+		bool want_write = false;
+
+		RetransmitWindow window;
+		sequence_number_t next_seqn = 1;
+
+		std::vector<Buffer::word_t> output;
+		size_t output_position = 0;
+
+		std::vector<Buffer::word_t> input;
+		size_t input_position = 0;
+		sequence_number_t max_received_seqn = 0;
+
+		SharedChunk chunk;
+		std::array<Buffer::word_t, MESSAGE_HEADER_LENGTH> message_header{};
+		int32_t message_header_filled = 0;
+		RdId::hash_t message_id = -1;
+		int32_t message_rest = -1;
+		Buffer message;
+		int32_t message_filled = 0;
+
+		/**
+		 * \brief Timestamp of this wire which increases at intervals of [heartBeatInterval].
+		 */
+		int32_t current_timestamp = 0;
+
+		/**
+		 * \brief Actual knowledge about counterpart's [currentTimeStamp].
+		 */
+		int32_t counterpart_timestamp = 0;
+
+		/**
+		 * \brief The latest received counterpart's acknowledge of this wire's [currentTimeStamp].
+		 */
+		int32_t counterpart_acknowledge_timestamp = 0;
+
+		Reactor::timer_id_t heartbeat_timer = 0;
+
+		void flush();
+
+		template <typename T>
+		void append_integral(T const& x)
+		{
+			auto const* bytes = reinterpret_cast<Buffer::word_t const*>(&x);
+			output.insert(output.end(), bytes, bytes + sizeof(T));
+		}
+
+		void append_package(Buffer::ByteArray const& package, sequence_number_t seqn);
+
+		void write_output();
+
+		void on_readable();
+
+		void parse_input();
+
+		void receive_package(Buffer::word_t const* data, int32_t len);
+
+		void dispatch_message(Buffer message);
+
+		void ping();
+
+		/**
+		 * \brief Starts serving connected nonblocking socket [new_fd]: replays unacknowledged packages and starts heartbeat.
+		 */
+		void attach(int new_fd);
+
+		void detach();
+
+		/**
+		 * \brief Called on the reactor thread when the connection is lost.
+		 */
+		virtual void on_disconnected() = 0;
+
+		/**
+		 * \brief Releases reactor resources of the wire. Called on the reactor thread once the wire lifetime is terminated.
+		 */
+		virtual void close();
+
+		/**
+		 * \brief Synchronously executes [close] on the reactor thread, no reactor callbacks are invoked afterwards.
+		 */
+		void terminate();
+
+	public:
+		static constexpr int32_t MaximumHeartbeatDelay = 3;
+		std::chrono::milliseconds heartBeatInterval = std::chrono::milliseconds(500);
+
+		// region ctor/dtor
+
+		Base(std::string id, IScheduler* scheduler, Reactor* reactor);
+
+		virtual ~Base() override = default;
+		// endregion
+
+		using WireBase::send;
+
+		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const override;
+
+		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
+
+		RetransmitWindow::Stats get_retransmit_stats() const;
+	};
+
+	class RD_FRAMEWORK_API Client : public Base
+	{
+		Reactor::timer_id_t reconnect_timer = 0;
+		int connecting_fd = -1;
+
+		void connect();
+
+		void on_connect_result(int new_fd);
+
+	protected:
+		void on_disconnected() override;
+
+		void close() override;
+
+	public:
+		uint16_t port = 0;
+
+		// region ctor/dtor
+
+		Client(Lifetime parentLifetime, IScheduler* scheduler, Reactor* reactor, uint16_t port = 0,
+			const std::string& id = "ClientSocket");
+
+		virtual ~Client() override;
+		// endregion
+
+	private:
+		LifetimeDefinition clientLifetimeDefinition;
+	};
+
+	class RD_FRAMEWORK_API Server : public Base
+	{
+		int listen_fd = -1;
+
+		void accept();
+
+	protected:
+		void on_disconnected() override;
+
+		void close() override;
+
+	public:
+		uint16_t port = 0;
+
+		// region ctor/dtor
+
+		Server(Lifetime parentLifetime, IScheduler* scheduler, Reactor* reactor, uint16_t port = 0,
+			const std::string& id = "ServerSocket");
+
+		virtual ~Server() override;
+		// endregion
+
+	private:
+		LifetimeDefinition serverLifetimeDefinition;
+	};
+};
+}	 // namespace rd
+
+#endif	  // __linux__
+
+#endif	  // RD_CPP_REACTORWIRE_H
@@ -0,0 +1,162 @@
+#include "RetransmitWindow.h"
+
+#include "protocol/BufferPool.h"
+#include "util/core_util.h"
+
+#include <algorithm>
+
+namespace rd
+{
+constexpr size_t RetransmitWindow::INITIAL_CAPACITY;
+
+RetransmitWindow::RetransmitWindow() : RetransmitWindow(Limits{})
+{
+}
+
+RetransmitWindow::RetransmitWindow(Limits limits) : slots(INITIAL_CAPACITY), limits(limits)
+{
+}
+
+void RetransmitWindow::set_limits(Limits new_limits)
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	limits = new_limits;
+}
+
+size_t RetransmitWindow::index_of(sequence_number_t seqn) const
+{
+	// capacity is always a power of two
+	return (head + static_cast<size_t>(seqn - first_seqn)) & (slots.size() - 1);
+}
+
+void RetransmitWindow::grow()
+{
+	std::vector<Buffer::ByteArray> new_slots(slots.size() * 2);
+	for (size_t i = 0; i < count; ++i)
+	{
+		new_slots[i] = std::move(slots[(head + i) & (slots.size() - 1)]);
+	}
+	slots = std::move(new_slots);
+	head = 0;
+}
+
+void RetransmitWindow::release_acknowledged()
+{
+	if (pinned)
+	{
+		return;
+	}
+	while (count > 0 && first_seqn <= acknowledged_seqn)
+	{
+		Buffer::ByteArray released;
+		released.swap(slots[head]);
+
+		retained_bytes -= released.size();
+		++released_packages;
+		released_bytes += released.size();
+		BufferPool::Instance().release(std::move(released));
+
+		head = (head + 1) & (slots.size() - 1);
+		--count;
+		++first_seqn;
+	}
+	if (count == 0)
+	{
+		first_seqn = (std::max)(first_seqn, acknowledged_seqn + 1);
+	}
+}
+
+void RetransmitWindow::push(sequence_number_t seqn, Buffer::ByteArray package)
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+
+	if (count == 0)
+	{
+		first_seqn = seqn;
+	}
+	RD_ASSERT_MSG(seqn == first_seqn + static_cast<sequence_number_t>(count),
+		"RetransmitWindow: non-consecutive seqn " + std::to_string(seqn) + ", expected " +
+			std::to_string(first_seqn + static_cast<sequence_number_t>(count)));
+
+	if (count == 0 && seqn <= acknowledged_seqn)
+	{
+		// the counterpart has already acknowledged this package while it was being sent
+		++first_seqn;
+		++released_packages;
+		released_bytes += package.size();
+		BufferPool::Instance().release(std::move(package));
+		return;
+	}
+
+	if (count == slots.size())
+	{
+		grow();
+	}
+	retained_bytes += package.size();
+	peak_retained_bytes = (std::max)(peak_retained_bytes, retained_bytes.load());
+	slots[index_of(seqn)] = std::move(package);
+	++count;
+}
+
+bool RetransmitWindow::acknowledge(sequence_number_t seqn)
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+
+	if (seqn <= acknowledged_seqn)
+	{
+		return false;
+	}
+	acknowledged_seqn = seqn;
+	release_acknowledged();
+	return true;
+}
+
+bool RetransmitWindow::has_room(size_t size, size_t packages) const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+
+	if (count == 0 && packages == 1)
+	{
+		return true;
+	}
+	if (limits.max_packages != 0 && count + packages > limits.max_packages)
+	{
+		return false;
+	}
+	if (limits.max_bytes != 0 && retained_bytes + size > limits.max_bytes)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool RetransmitWindow::empty() const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	return count == 0;
+}
+
+sequence_number_t RetransmitWindow::get_acknowledged_seqn() const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	return acknowledged_seqn;
+}
+
+size_t RetransmitWindow::get_retained_bytes() const
+{
+	return retained_bytes;
+}
+
+RetransmitWindow::Stats RetransmitWindow::get_stats() const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+
+	Stats stats;
+	stats.retained_packages = count;
+	stats.retained_bytes = retained_bytes;
+	stats.peak_retained_bytes = peak_retained_bytes;
+	stats.released_packages = released_packages;
+	stats.released_bytes = released_bytes;
+	return stats;
+}
+}	 // namespace rd
@@ -0,0 +1,160 @@
+#ifndef RD_CPP_RETRANSMITWINDOW_H
+#define RD_CPP_RETRANSMITWINDOW_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/Buffer.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+using sequence_number_t = int64_t;
+
+/**
+ * \brief Ring buffer of packages which were sent but not acknowledged by the counterpart yet.
+ * Packages are keyed by their consecutive sequence numbers and are released as soon as an ACK covering them arrives,
+ * so retained memory is proportional to the data in flight rather than to the session length.
+ * Released packages are given back to BufferPool::Instance().
+ */
+class RD_FRAMEWORK_API RetransmitWindow
+{
+public:
+	/**
+	 * \brief Upper bounds of the window, zero means unbounded. When the window is full the owner is expected to stop
+	 * sending new packages until acknowledges release some space (backpressure).
+	 */
+	struct Limits
+	{
+		size_t max_packages = 0;
+		size_t max_bytes = 0;
+	};
+
+	struct Stats
+	{
+		size_t retained_packages = 0;
+		size_t retained_bytes = 0;
+		size_t peak_retained_bytes = 0;
+		uint64_t released_packages = 0;
+		uint64_t released_bytes = 0;
+	};
+
+private:
+	static constexpr size_t INITIAL_CAPACITY = 64;
+
+	mutable std::mutex lock;
+
+	std::vector<Buffer::ByteArray> slots;
+	size_t head = 0;
+	size_t count = 0;
+
+	sequence_number_t first_seqn = 1;
+	sequence_number_t acknowledged_seqn = 0;
+
+	Limits limits;
+
+	bool pinned = false;
+
+	std::atomic<size_t> retained_bytes{0};
+	size_t peak_retained_bytes = 0;
+	uint64_t released_packages = 0;
+	uint64_t released_bytes = 0;
+
+	size_t index_of(sequence_number_t seqn) const;
+
+	void grow();
+
+	void release_acknowledged();
+
+public:
+	// region ctor/dtor
+
+	RetransmitWindow();
+
+	explicit RetransmitWindow(Limits limits);
+
+	RetransmitWindow(RetransmitWindow const&) = delete;
+
+	RetransmitWindow& operator=(RetransmitWindow const&) = delete;
+
+	// endregion
+
+	void set_limits(Limits new_limits);
+
+	/**
+	 * \brief Retains package [seqn] which has been just sent. Sequence numbers must be pushed consecutively.
+	 * Packages already covered by the latest acknowledge are dropped immediately.
+	 */
+	void push(sequence_number_t seqn, Buffer::ByteArray package);
+
+	/**
+	 * \brief Releases all packages with sequence number less or equal to [seqn].
+	 * \return false if [seqn] isn't greater than the previously acknowledged one.
+	 */
+	bool acknowledge(sequence_number_t seqn);
+
+	/**
+	 * \brief Invokes [f] on every retained package in order of sequence numbers. Packages aren't released while
+	 * replay is in progress, so [f] is allowed to block (e.g. on a socket) without holding the window lock.
+	 * \return false if [f] returned false for some package, replay is interrupted in that case.
+	 */
+	template <typename F>
+	bool replay(F&& f)
+	{
+		sequence_number_t from, to;
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			pinned = true;
+			from = first_seqn;
+			to = first_seqn + static_cast<sequence_number_t>(count);
+		}
+		bool result = true;
+		for (sequence_number_t seqn = from; seqn < to; ++seqn)
+		{
+			Buffer::ByteArray const* package;
+			{
+				std::lock_guard<decltype(lock)> guard(lock);
+				package = &slots[index_of(seqn)];
+			}
+			if (!f(*package, seqn))
+			{
+				result = false;
+				break;
+			}
+		}
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			pinned = false;
+			release_acknowledged();
+		}
+		return result;
+	}
+
+	/**
+	 * \return whether [packages] packages of [size] bytes in total fit into the window limits. An empty window always
+	 * accepts a single package to guarantee progress.
+	 */
+	bool has_room(size_t size, size_t packages = 1) const;
+
+	bool empty() const;
+
+	sequence_number_t get_acknowledged_seqn() const;
+
+	size_t get_retained_bytes() const;
+
+	Stats get_stats() const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_RETRANSMITWINDOW_H
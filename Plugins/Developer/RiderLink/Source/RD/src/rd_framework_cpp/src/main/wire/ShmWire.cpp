@@ -0,0 +1,761 @@
+#include "wire/ShmWire.h"
+
+#if defined(__linux__)
+
+#include "scheduler/TimerWheel.h"
+
+#include <util/thread_util.h>
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+
+namespace rd
+{
+namespace
+{
+constexpr uint32_t SEGMENT_MAGIC = 0x52445348;	  // "RDSH"
+constexpr uint32_t SEGMENT_VERSION = 1;
+
+// states of the client slot, the word is also used as a futex
+constexpr uint32_t CLIENT_FREE = 0;
+constexpr uint32_t CLIENT_ATTACHED = 1;
+constexpr uint32_t CLIENT_DETACHED = 2;
+
+// sleeping on a futex is bounded, so liveness of the counterpart and termination are checked periodically
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(100);
+
+void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::milliseconds timeout)
+{
+	timespec ts{};
+	ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+	ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+	// not FUTEX_PRIVATE_FLAG: the word is shared with another process
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>* word)
+{
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+bool process_alive(uint32_t pid)
+{
+	return pid == 0 || kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+size_t round_up_to_power_of_two(size_t value)
+{
+	size_t result = 64;
+	while (result < value)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+}	 // namespace
+
+/**
+ * \brief Single-producer single-consumer byte ring. Positions grow monotonically and are masked on access.
+ * [data_seq] and [space_seq] are futex words the consumer and the producer sleep on respectively.
+ */
+struct ShmWire::Base::Ring
+{
+	alignas(64) std::atomic<uint64_t> head;
+	alignas(64) std::atomic<uint64_t> tail;
+	alignas(64) std::atomic<uint32_t> data_seq;
+	std::atomic<uint32_t> consumer_waiting;
+	alignas(64) std::atomic<uint32_t> space_seq;
+	std::atomic<uint32_t> producer_waiting;
+
+	void reset()
+	{
+		head = 0;
+		tail = 0;
+		consumer_waiting = 0;
+		producer_waiting = 0;
+	}
+
+	static void wake(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiting)
+	{
+		// pairs with the fence in sleep: either the sleeper is seen here or it sees the new position
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiting.load(std::memory_order_relaxed) != 0)
+		{
+			seq.fetch_add(1);
+			futex_wake(&seq);
+		}
+	}
+
+	template <typename F>
+	static void sleep(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiting, F&& ready)
+	{
+		const uint32_t observed = seq.load();
+		waiting.store(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!ready())
+		{
+			futex_wait(&seq, observed, POLL_INTERVAL);
+		}
+		waiting.store(0);
+	}
+};
+
+/**
+ * \brief Layout of the shared memory object, the rings' data follows the header.
+ */
+struct ShmWire::Base::Segment
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t capacity;
+	std::atomic<uint32_t> server_pid;
+	std::atomic<uint32_t> server_closed;
+	std::atomic<uint32_t> client_pid;
+	std::atomic<uint32_t> client_state;
+	// [0] carries data from the server to the client, [1] in the opposite direction
+	Ring rings[2];
+
+	static constexpr size_t header_size()
+	{
+		return (sizeof(Segment) + 63) / 64 * 64;
+	}
+};
+
+std::shared_ptr<spdlog::logger> ShmWire::Base::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("shmWireLog", spdlog::color_mode::automatic);
+
+std::chrono::milliseconds ShmWire::timeout = std::chrono::milliseconds(500);
+
+constexpr int32_t ShmWire::Base::ACK_MESSAGE_LENGTH;
+constexpr int32_t ShmWire::Base::PING_MESSAGE_LENGTH;
+constexpr int32_t ShmWire::Base::PACKAGE_HEADER_LENGTH;
+constexpr int32_t ShmWire::Base::CAPABILITY_FLAGS;
+constexpr size_t ShmWire::Base::DEFAULT_MAX_SEND_BATCH_SIZE;
+constexpr size_t ShmWire::Base::DEFAULT_RING_CAPACITY;
+
+ShmWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler)
+	: WireBase(scheduler), id(std::move(id)), lifetimeDef(parentLifetime)
+{
+	async_send_buffer.pause("initial");
+	async_send_buffer.start();
+}
+
+ShmWire::Base::~Base()
+{
+	if (!lifetimeDef.is_terminated())
+	{
+		lifetimeDef.terminate();
+	}
+}
+
+bool ShmWire::Base::map(int fd, size_t size, bool server)
+{
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (address == MAP_FAILED)
+	{
+		logger->error("{}: failed to map shared memory, reason: {}", this->id, std::strerror(errno));
+		return false;
+	}
+	segment = static_cast<Segment*>(address);
+	segment_size = size;
+	if (server)
+	{
+		new (segment) Segment();
+		segment->capacity = (size - Segment::header_size()) / 2;
+		segment->server_pid = static_cast<uint32_t>(getpid());
+		segment->rings[0].reset();
+		segment->rings[1].reset();
+		segment->version = SEGMENT_VERSION;
+		std::atomic_thread_fence(std::memory_order_release);
+		segment->magic = SEGMENT_MAGIC;
+	}
+	else if (segment->magic != SEGMENT_MAGIC || segment->version != SEGMENT_VERSION ||
+			 Segment::header_size() + 2 * segment->capacity > size)
+	{
+		logger->error("{}: incompatible shared memory layout", this->id);
+		unmap();
+		return false;
+	}
+
+	capacity = segment->capacity;
+	auto base = reinterpret_cast<Buffer::word_t*>(segment) + Segment::header_size();
+	out = &segment->rings[server ? 0 : 1];
+	in = &segment->rings[server ? 1 : 0];
+	out_data = base + (server ? 0 : capacity);
+	in_data = base + (server ? capacity : 0);
+	return true;
+}
+
+void ShmWire::Base::unmap()
+{
+	if (segment != nullptr)
+	{
+		munmap(segment, segment_size);
+		segment = nullptr;
+		out = in = nullptr;
+		out_data = in_data = nullptr;
+	}
+}
+
+bool ShmWire::Base::session_alive() const
+{
+	return !closing && peer_alive();
+}
+
+void ShmWire::Base::wake_all()
+{
+	for (Ring& ring : segment->rings)
+	{
+		ring.data_seq.fetch_add(1);
+		futex_wake(&ring.data_seq);
+		ring.space_seq.fetch_add(1);
+		futex_wake(&ring.space_seq);
+	}
+	futex_wake(&segment->client_state);
+}
+
+bool ShmWire::Base::write_to_ring(Buffer::word_t const* src, size_t len, bool wait)
+{
+	const uint64_t mask = capacity - 1;
+	uint64_t head = out->head.load(std::memory_order_relaxed);
+	if (!wait && capacity - (head - out->tail.load(std::memory_order_acquire)) < len)
+	{
+		return false;
+	}
+	while (len > 0)
+	{
+		const uint64_t free = capacity - (head - out->tail.load(std::memory_order_acquire));
+		if (free == 0)
+		{
+			if (!session_alive())
+			{
+				return false;
+			}
+			// the consumer must see what has been written so far, otherwise both sides may sleep
+			Ring::wake(out->data_seq, out->consumer_waiting);
+			Ring::sleep(out->space_seq, out->producer_waiting,
+				[this, head] { return out->tail.load(std::memory_order_acquire) + capacity != head; });
+			continue;
+		}
+		const size_t n = static_cast<size_t>((std::min)(static_cast<uint64_t>(len), free));
+		const size_t offset = static_cast<size_t>(head & mask);
+		const size_t first = (std::min)(n, static_cast<size_t>(capacity) - offset);
+		std::memcpy(out_data + offset, src, first);
+		std::memcpy(out_data, src + first, n - first);
+		head += n;
+		src += n;
+		len -= n;
+		out->head.store(head, std::memory_order_release);
+	}
+	return true;
+}
+
+void ShmWire::Base::flush_ring()
+{
+	Ring::wake(out->data_seq, out->consumer_waiting);
+}
+
+bool ShmWire::Base::read_from_ring(Buffer::word_t* dst, size_t len)
+{
+	const uint64_t mask = capacity - 1;
+	uint64_t tail = in->tail.load(std::memory_order_relaxed);
+	while (len > 0)
+	{
+		const uint64_t available = in->head.load(std::memory_order_acquire) - tail;
+		if (available == 0)
+		{
+			if (!session_alive())
+			{
+				return false;
+			}
+			Ring::sleep(
+				in->data_seq, in->consumer_waiting, [this, tail] { return in->head.load(std::memory_order_acquire) != tail; });
+			continue;
+		}
+		const size_t n = static_cast<size_t>((std::min)(static_cast<uint64_t>(len), available));
+		const size_t offset = static_cast<size_t>(tail & mask);
+		const size_t first = (std::min)(n, static_cast<size_t>(capacity) - offset);
+		std::memcpy(dst, in_data + offset, first);
+		std::memcpy(dst + first, in_data, n - first);
+		tail += n;
+		dst += n;
+		len -= n;
+		in->tail.store(tail, std::memory_order_release);
+		Ring::wake(in->space_seq, in->producer_waiting);
+	}
+	return true;
+}
+
+static constexpr std::pair<int32_t, sequence_number_t> INVALID_HEADER = std::make_pair(-1, -1);
+
+std::pair<int32_t, sequence_number_t> ShmWire::Base::read_header()
+{
+	int32_t len = 0;
+	sequence_number_t seqn = 0;
+	while (true)
+	{
+		if (!read_integral_from_ring(len))
+		{
+			return INVALID_HEADER;
+		}
+		if (len == PING_MESSAGE_LENGTH)
+		{
+			int32_t received_timestamp = 0;
+			int32_t received_counterpart_timestamp = 0;
+			if (!read_integral_from_ring(received_timestamp) || !read_integral_from_ring(received_counterpart_timestamp))
+			{
+				return INVALID_HEADER;
+			}
+			counterpart_timestamp = received_timestamp & ~CAPABILITY_FLAGS;
+			counterpart_acknowledge_timestamp = received_counterpart_timestamp;
+			if (connection_established(current_timestamp, counterpart_acknowledge_timestamp))
+			{
+				heartbeatAlive.set(true);
+			}
+			continue;
+		}
+		if (!read_integral_from_ring(seqn))
+		{
+			return INVALID_HEADER;
+		}
+		if (len == ACK_MESSAGE_LENGTH)
+		{
+			async_send_buffer.acknowledge(seqn);
+			continue;
+		}
+		return std::make_pair(len, seqn);
+	}
+}
+
+int32_t ShmWire::Base::read_package()
+{
+	while (true)
+	{
+		receive_pkg.rewind();
+
+		const auto pair = read_header();
+		if (pair == INVALID_HEADER)
+		{
+			logger->debug("{}: failed to read header", this->id);
+			return -1;
+		}
+		const auto len = pair.first;
+		const auto seqn = pair.second;
+		// packages bigger than the ring stream through it, so the length is bounded by the package limit instead
+		if (len < 0 || len > MAX_PACKAGE_SIZE)
+		{
+			logger->error("{}: malformed package length {}, seqn={}", this->id, len, seqn);
+			return -1;
+		}
+
+		receive_pkg.require_available(len);
+		if (!read_from_ring(receive_pkg.data(), len))
+		{
+			logger->debug("{}: failed to read package", this->id);
+			return -1;
+		}
+		send_ack(seqn);
+		if (seqn <= max_received_seqn && seqn != 1)
+		{
+			// already received before reconnect, skip it
+			continue;
+		}
+		max_received_seqn = seqn;
+
+		logger->trace("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+		return len;
+	}
+}
+
+bool ShmWire::Base::read_and_dispatch_message()
+{
+	sz = (sz == -1 ? receive_pkg.read_integral<int32_t>() : sz);
+	if (sz == -1)
+	{
+		return false;
+	}
+	id_ = (id_ == -1 ? receive_pkg.read_integral<RdId::hash_t>() : id_);
+	if (id_ == -1)
+	{
+		return false;
+	}
+	const RdId rd_id{id_};
+	sz -= 8;	// RdId
+
+	optional<Buffer> view = receive_pkg.try_read_view(sz);
+	if (view)
+	{
+		message_broker.dispatch(rd_id, *std::move(view));
+	}
+	else
+	{
+		Buffer message(sz);
+		if (!receive_pkg.read(message.data(), sz))
+		{
+			logger->error("{}: constructing message failed", this->id);
+			return false;
+		}
+		message_broker.dispatch(rd_id, std::move(message));
+	}
+
+	sz = -1;
+	id_ = -1;
+	return true;
+}
+
+void ShmWire::Base::receiverProc()
+{
+	// [receive_pkg] ends and begins a batch around reading each package, the guard ends the last one
+	MessageBroker::BatchGuard batch_guard(message_broker);
+	while (!closing)
+	{
+		try
+		{
+			if (!read_and_dispatch_message())
+			{
+				logger->debug("{}: counterpart detached", this->id);
+				break;
+			}
+		}
+		catch (std::exception const& ex)
+		{
+			logger->error("{} caught processing | {}", this->id, ex.what());
+			break;
+		}
+	}
+}
+
+void ShmWire::Base::run_session()
+{
+	LifetimeDefinition::use([this](Lifetime heartbeatLifetime) {
+		TimerWheel::Instance().schedule(heartbeatLifetime, heartBeatInterval, [this] { ping(); }, heartBeatInterval);
+
+		async_send_buffer.resume();
+
+		connected.set(true);
+
+		receiverProc();
+
+		connected.set(false);
+
+		async_send_buffer.pause("Disconnected");
+	});
+}
+
+bool ShmWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seqn)
+{
+	Buffer::ByteArray const* packages[] = {&msg};
+	return send_batch0(packages, 1, seqn);
+}
+
+bool ShmWire::Base::send_batch0(Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn)
+{
+	std::unique_lock<decltype(write_lock)> guard(write_lock);
+	for (size_t i = 0; i < count; ++i)
+	{
+		Buffer::word_t header[PACKAGE_HEADER_LENGTH];
+		const int32_t len = static_cast<int32_t>(packages[i]->size());
+		const sequence_number_t seqn = first_seqn + static_cast<sequence_number_t>(i);
+		std::memcpy(header, &len, sizeof(len));
+		std::memcpy(header + sizeof(len), &seqn, sizeof(seqn));
+		if (!write_to_ring(header, PACKAGE_HEADER_LENGTH, true) || !write_to_ring(packages[i]->data(), len, true))
+		{
+			logger->warn("{}: failed to send package, counterpart detached", this->id);
+			return false;
+		}
+	}
+	write_unsent_ack();
+	// a single wake up for the whole batch
+	flush_ring();
+	guard.unlock();
+	// the receiver may have given up on the lock while the batch was being written
+	if (unsent_ack.load() != 0)
+	{
+		try_write_unsent_ack();
+	}
+	return true;
+}
+
+void ShmWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const
+{
+	async_send_buffer.put(write_message(rd_id, writer, size_hint));
+}
+
+bool ShmWire::Base::connection_established(int32_t timestamp, int32_t acknowledged_timestamp)
+{
+	return timestamp - acknowledged_timestamp <= MaximumHeartbeatDelay;
+}
+
+void ShmWire::Base::ping()
+{
+	if (!connection_established(current_timestamp, counterpart_acknowledge_timestamp))
+	{
+		heartbeatAlive.set(false);
+	}
+	Buffer::word_t ping[PACKAGE_HEADER_LENGTH];
+	std::memcpy(ping, &PING_MESSAGE_LENGTH, sizeof(int32_t));
+	std::memcpy(ping + sizeof(int32_t), &current_timestamp, sizeof(int32_t));
+	std::memcpy(ping + 2 * sizeof(int32_t), &counterpart_timestamp, sizeof(int32_t));
+	{
+		// the heartbeat runs on the shared timer wheel thread, so it never waits for the ring, skipping the beat instead
+		std::unique_lock<decltype(write_lock)> guard(write_lock, std::try_to_lock);
+		if (!guard.owns_lock())
+		{
+			return;
+		}
+		write_unsent_ack();
+		const bool written = write_to_ring(ping, PACKAGE_HEADER_LENGTH, false);
+		flush_ring();
+		if (!written)
+		{
+			return;
+		}
+	}
+	++current_timestamp;
+}
+
+bool ShmWire::Base::send_ack(sequence_number_t seqn)
+{
+	// the receiver never waits for [out]: if both rings are full, the counterpart's receiver may be waiting for ours.
+	// An acknowledge which can't be written now is coalesced with the next one, the sender or the heartbeat retry it
+	unsent_ack.store(seqn);
+	return try_write_unsent_ack();
+}
+
+bool ShmWire::Base::try_write_unsent_ack()
+{
+	std::unique_lock<decltype(write_lock)> guard(write_lock, std::try_to_lock);
+	if (guard.owns_lock())
+	{
+		write_unsent_ack();
+		flush_ring();
+	}
+	return unsent_ack.load() == 0;
+}
+
+void ShmWire::Base::write_unsent_ack()
+{
+	sequence_number_t seqn = unsent_ack.exchange(0);
+	if (seqn == 0)
+	{
+		return;
+	}
+	Buffer::word_t ack[PACKAGE_HEADER_LENGTH];
+	std::memcpy(ack, &ACK_MESSAGE_LENGTH, sizeof(int32_t));
+	std::memcpy(ack + sizeof(int32_t), &seqn, sizeof(seqn));
+	if (!write_to_ring(ack, PACKAGE_HEADER_LENGTH, false))
+	{
+		// keep it unless the receiver has already stored a newer one
+		sequence_number_t none = 0;
+		unsent_ack.compare_exchange_strong(none, seqn);
+	}
+}
+
+ShmWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, std::string name, const std::string& id)
+	: Base(id, parentLifetime, scheduler), name(std::move(name)), clientLifetimeDefinition(parentLifetime)
+{
+	Lifetime lifetime = clientLifetimeDefinition.lifetime;
+	thread = std::thread([this, lifetime] {
+		rd::util::set_thread_name(this->id.empty() ? "ShmWire::Client Thread" : this->id.c_str());
+		logger->info("{}: started, name: {}.", this->id, this->name);
+
+		while (!lifetime->is_terminated())
+		{
+			if (attach())
+			{
+				run_session();
+				detach();
+			}
+			std::unique_lock<decltype(lock)> guard(lock);
+			if (!lifetime->is_terminated())
+			{
+				cv.wait_for(guard, timeout);
+			}
+		}
+		logger->info("{}: terminated, name: {}.", this->id, this->name);
+	});
+
+	lifetime->add_action([this] {
+		logger->info("{}: starts terminating lifetime", this->id);
+
+		closing = true;
+		{
+			// don't wait for the poll interval of the rings, the mapping is guarded by [lock]
+			std::lock_guard<decltype(lock)> guard(lock);
+			if (segment != nullptr)
+			{
+				wake_all();
+			}
+		}
+		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
+		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+		}
+		cv.notify_all();
+
+		thread.join();
+		logger->info("{}: termination finished", this->id);
+	});
+}
+
+ShmWire::Client::~Client()
+{
+	if (!clientLifetimeDefinition.is_terminated())
+	{
+		clientLifetimeDefinition.terminate();
+	}
+}
+
+bool ShmWire::Client::attach()
+{
+	const int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd == -1)
+	{
+		logger->debug("{}: failed to open shared memory {}, reason: {}", this->id, name, std::strerror(errno));
+		return false;
+	}
+	std::lock_guard<decltype(lock)> guard(lock);
+	struct stat info
+	{
+	};
+	const bool mapped = fstat(fd, &info) == 0 && info.st_size > 0 && map(fd, static_cast<size_t>(info.st_size), false);
+	close(fd);
+	if (!mapped)
+	{
+		return false;
+	}
+
+	uint32_t expected = CLIENT_FREE;
+	if (segment->server_closed.load() != 0 || !segment->client_state.compare_exchange_strong(expected, CLIENT_ATTACHED))
+	{
+		logger->debug("{}: shared memory {} is busy", this->id, name);
+		unmap();
+		return false;
+	}
+	segment->client_pid = static_cast<uint32_t>(getpid());
+	futex_wake(&segment->client_state);
+	logger->info("{}: attached to {}", this->id, name);
+	return true;
+}
+
+void ShmWire::Client::detach()
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	segment->client_state = CLIENT_DETACHED;
+	wake_all();
+	unmap();
+	logger->info("{}: detached from {}", this->id, name);
+}
+
+bool ShmWire::Client::peer_alive() const
+{
+	return segment->server_closed.load() == 0 && segment->client_state.load() == CLIENT_ATTACHED &&
+		   process_alive(segment->server_pid.load());
+}
+
+ShmWire::Server::Server(
+	Lifetime parentLifetime, IScheduler* scheduler, std::string name, size_t ring_capacity, const std::string& id)
+	: Base(id, parentLifetime, scheduler), name(std::move(name)), serverLifetimeDefinition(parentLifetime)
+{
+	if (this->name.empty())
+	{
+		static std::atomic<uint32_t> counter{0};
+		this->name = "/rd-shm-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+	}
+
+	const int fd = shm_open(this->name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	RD_ASSERT_THROW_MSG(
+		fd != -1, fmt::format("{}: failed to create shared memory {}, reason: {}", this->id, this->name, std::strerror(errno)));
+	const size_t size = Segment::header_size() + 2 * round_up_to_power_of_two(ring_capacity);
+	const bool mapped = ftruncate(fd, static_cast<off_t>(size)) == 0 && map(fd, size, true);
+	close(fd);
+	if (!mapped)
+	{
+		shm_unlink(this->name.c_str());
+		RD_ASSERT_THROW_MSG(false, fmt::format("{}: failed to map shared memory {}", this->id, this->name));
+	}
+	logger->info("{}: listening {}", this->id, this->name);
+
+	Lifetime lifetime = serverLifetimeDefinition.lifetime;
+	thread = std::thread([this, lifetime] {
+		rd::util::set_thread_name(this->id.empty() ? "ShmWire::Server Thread" : this->id.c_str());
+
+		while (!lifetime->is_terminated())
+		{
+			const uint32_t state = segment->client_state.load();
+			if (state == CLIENT_FREE)
+			{
+				futex_wait(&segment->client_state, state, POLL_INTERVAL);
+				continue;
+			}
+			if (state == CLIENT_ATTACHED)
+			{
+				logger->info("{}: client attached", this->id);
+				run_session();
+			}
+			if (!lifetime->is_terminated())
+			{
+				reset_session();
+			}
+		}
+		logger->info("{}: terminated, name: {}.", this->id, this->name);
+	});
+
+	lifetime->add_action([this] {
+		logger->info("{}: start terminating lifetime", this->id);
+
+		closing = true;
+		segment->server_closed = 1;
+		wake_all();
+
+		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
+		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+
+		thread.join();
+
+		shm_unlink(this->name.c_str());
+		unmap();
+		logger->info("{}: termination finished", this->id);
+	});
+}
+
+ShmWire::Server::~Server()
+{
+	if (!serverLifetimeDefinition.is_terminated())
+	{
+		serverLifetimeDefinition.terminate();
+	}
+}
+
+void ShmWire::Server::reset_session()
+{
+	// the client has detached (or died) and our sender is paused, nobody touches the rings
+	segment->rings[0].reset();
+	segment->rings[1].reset();
+	segment->client_pid = 0;
+	segment->client_state = CLIENT_FREE;
+	futex_wake(&segment->client_state);
+	logger->info("{}: ready for a new client", this->id);
+}
+
+bool ShmWire::Server::peer_alive() const
+{
+	return segment->client_state.load() == CLIENT_ATTACHED && process_alive(segment->client_pid.load());
+}
+}	 // namespace rd
+
+#endif	  // __linux__
@@ -0,0 +1,244 @@
+#ifndef RD_CPP_SHMWIRE_H
+#define RD_CPP_SHMWIRE_H
+
+#if defined(__linux__)
+
+#include "base/WireBase.h"
+#include "ByteBufferAsyncProcessor.h"
+#include "PkgInputStream.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Wire for peers on the same host. Packages travel through a pair of single-producer single-consumer byte rings
+ * (one per direction) in a POSIX shared memory object, sleeping readers and writers are woken up with futexes.
+ * Framing, acknowledges and heartbeat are the same as in SocketWire, so unacknowledged packages are replayed
+ * by ByteBufferAsyncProcessor after the counterpart reconnects.
+ */
+class RD_FRAMEWORK_API ShmWire
+{
+	static std::chrono::milliseconds timeout;
+
+public:
+	class RD_FRAMEWORK_API Base : public WireBase
+	{
+	protected:
+		struct Ring;
+		struct Segment;
+
+		static std::shared_ptr<spdlog::logger> logger;
+
+		static constexpr int32_t ACK_MESSAGE_LENGTH = -1;
+		static constexpr int32_t PING_MESSAGE_LENGTH = -2;
+		static constexpr int32_t PACKAGE_HEADER_LENGTH = sizeof(ACK_MESSAGE_LENGTH) + sizeof(sequence_number_t);
+		// bits SocketWire announces its capabilities with in the ping timestamps, this wire has none but tolerates them
+		static constexpr int32_t CAPABILITY_FLAGS = 0x70000000;
+		static constexpr size_t DEFAULT_MAX_SEND_BATCH_SIZE = 64;
+
+		std::string id;
+
+		std::thread thread{};
+
+		// mapping of the shared memory object, owned by the thread of the wire
+		Segment* segment = nullptr;
+		size_t segment_size = 0;
+		Ring* out = nullptr;
+		Ring* in = nullptr;
+		Buffer::word_t* out_data = nullptr;
+		Buffer::word_t* in_data = nullptr;
+		uint64_t capacity = 0;
+
+		// several threads (sender, receiver with acknowledges and heartbeat) produce into [out]
+		std::mutex write_lock;
+
+		// the latest acknowledge the receiver couldn't write without waiting (0 if none), acknowledges are cumulative
+		std::atomic<sequence_number_t> unsent_ack{0};
+
+		// set by termination to interrupt waiting for the rings
+		std::atomic<bool> closing{false};
+
+		mutable ByteBufferAsyncProcessor async_send_buffer{id + "-AsyncSendProcessor",
+			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); },
+			[this](Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn) -> bool {
+				return this->send_batch0(packages, count, first_seqn);
+			},
+			DEFAULT_MAX_SEND_BATCH_SIZE};
+
+		/**
+		 * \brief Timestamp of this wire which increases at intervals of [heartBeatInterval].
+		 */
+		int32_t current_timestamp = 0;
+
+		/**
+		 * \brief Actual knowledge about counterpart's [currentTimeStamp].
+		 */
+		int32_t counterpart_timestamp = 0;
+
+		/**
+		 * \brief The latest received counterpart's acknowledge of this wire's [currentTimeStamp].
+		 */
+		int32_t counterpart_acknowledge_timestamp = 0;
+
+		sequence_number_t max_received_seqn = 0;
+
+		int32_t sz = -1;
+		RdId::hash_t id_ = -1;
+		// the messages of a package are handed over to the scheduler at once, before waiting for the next one
+		PkgInputStream receive_pkg{[this]() -> int32_t {
+			message_broker.end_batch();
+			const int32_t len = this->read_package();
+			message_broker.begin_batch();
+			return len;
+		}};
+
+		LifetimeDefinition lifetimeDef;
+
+		/**
+		 * \brief Maps [size] bytes of the shared memory object [fd], the server side initializes the layout.
+		 */
+		bool map(int fd, size_t size, bool server);
+
+		void unmap();
+
+		/**
+		 * \brief Whether the counterpart is still attached to the segment.
+		 */
+		virtual bool peer_alive() const = 0;
+
+		bool session_alive() const;
+
+		/**
+		 * \brief Copies [len] bytes to the outgoing ring, waiting for free space if [wait] is set.
+		 * The consumer isn't woken up until \ref flush_ring is called.
+		 */
+		bool write_to_ring(Buffer::word_t const* src, size_t len, bool wait);
+
+		void flush_ring();
+
+		/**
+		 * \brief Writes \ref unsent_ack if there is room in the outgoing ring, [write_lock] must be held.
+		 */
+		void write_unsent_ack();
+
+		/**
+		 * \brief Writes \ref unsent_ack unless [write_lock] is busy, returns whether no acknowledge is left unsent.
+		 */
+		bool try_write_unsent_ack();
+
+		bool read_from_ring(Buffer::word_t* dst, size_t len);
+
+		template <typename T>
+		bool read_integral_from_ring(T& x)
+		{
+			return read_from_ring(reinterpret_cast<Buffer::word_t*>(&x), sizeof(T));
+		}
+
+		void wake_all();
+
+		std::pair<int32_t, sequence_number_t> read_header();
+
+		int32_t read_package();
+
+		bool read_and_dispatch_message();
+
+		void receiverProc();
+
+		/**
+		 * \brief Serves the connection until the counterpart detaches or the wire is terminated.
+		 */
+		void run_session();
+
+	public:
+		static constexpr int32_t MaximumHeartbeatDelay = 3;
+		std::chrono::milliseconds heartBeatInterval = std::chrono::milliseconds(500);
+
+		/**
+		 * \brief Size of each ring, rounded up to a power of two.
+		 */
+		static constexpr size_t DEFAULT_RING_CAPACITY = 1u << 20;
+
+		// region ctor/dtor
+
+		Base(std::string id, Lifetime lifetime, IScheduler* scheduler);
+
+		virtual ~Base() override;
+		// endregion
+
+		bool send0(Buffer::ByteArray const& msg, sequence_number_t seqn);
+
+		bool send_batch0(Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn);
+
+		using WireBase::send;
+
+		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const override;
+
+		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
+
+		void ping();
+
+		bool send_ack(sequence_number_t seqn);
+	};
+
+	class RD_FRAMEWORK_API Client : public Base
+	{
+		std::mutex lock;
+		std::condition_variable cv;
+
+		bool attach();
+
+		void detach();
+
+	protected:
+		bool peer_alive() const override;
+
+	public:
+		std::string name;
+
+		// region ctor/dtor
+
+		Client(Lifetime parentLifetime, IScheduler* scheduler, std::string name, const std::string& id = "ClientShm");
+
+		virtual ~Client() override;
+		// endregion
+
+	private:
+		LifetimeDefinition clientLifetimeDefinition;
+	};
+
+	class RD_FRAMEWORK_API Server : public Base
+	{
+		void reset_session();
+
+	protected:
+		bool peer_alive() const override;
+
+	public:
+		/**
+		 * \brief Name of the shared memory object to be passed to the client.
+		 */
+		std::string name;
+
+		// region ctor/dtor
+
+		Server(Lifetime parentLifetime, IScheduler* scheduler, std::string name = "",
+			size_t ring_capacity = DEFAULT_RING_CAPACITY, const std::string& id = "ServerShm");
+
+		virtual ~Server() override;
+		// endregion
+
+	private:
+		LifetimeDefinition serverLifetimeDefinition;
+	};
+};
+}	 // namespace rd
+
+#endif	  // __linux__
+
+#endif	  // RD_CPP_SHMWIRE_H
@@ -1,5 +1,9 @@
 #include "wire/SocketWire.h"
 
+#include "protocol/BufferPool.h"
+#include "scheduler/TimerWheel.h"
+#include "util/compression.h"
+
 #include <util/thread_util.h>
 
 #include "spdlog/sinks/stdout_color_sinks.h"
@@ -11,6 +15,13 @@
 #include <utility>
 #include <thread>
 #include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
 
 namespace rd
 {
@@ -22,6 +33,26 @@ std::chrono::milliseconds SocketWire::timeout = std::chrono::milliseconds(500);
 constexpr int32_t SocketWire::Base::ACK_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PING_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PACKAGE_HEADER_LENGTH;
+constexpr int32_t SocketWire::Base::DIRECT_RECEIVE_THRESHOLD;
+constexpr size_t SocketWire::Base::DEFAULT_MAX_SEND_BATCH_SIZE;
+constexpr int32_t SocketWire::Base::COMPRESSED_PACKAGE_FLAG;
+constexpr int32_t SocketWire::Base::COMPRESSION_CAPABILITY_FLAG;
+constexpr int32_t SocketWire::Base::COMPACT_MESSAGE_FLAG;
+constexpr int32_t SocketWire::Base::COMPACT_ENCODING_CAPABILITY_FLAG;
+constexpr int32_t SocketWire::Base::FRAGMENT_MESSAGE_FLAG;
+constexpr int32_t SocketWire::Base::LAST_FRAGMENT_FLAG;
+constexpr int32_t SocketWire::Base::FRAGMENT_FLAGS;
+constexpr int32_t SocketWire::Base::FRAGMENT_CAPABILITY_FLAG;
+constexpr int32_t SocketWire::Base::CAPABILITY_FLAGS;
+constexpr size_t SocketWire::Base::FRAGMENT_SIZE;
+constexpr size_t SocketWire::Base::MAX_QUEUED_FRAGMENTS;
+constexpr size_t SocketWire::Base::MAX_REASSEMBLED_MESSAGES;
+constexpr size_t SocketWire::Base::MAX_REASSEMBLED_BYTES;
+
+static std::string describe_endpoint(uint16_t port, std::string const& unix_path)
+{
+	return unix_path.empty() ? fmt::format("127.0.0.1:{}", port) : fmt::format("unix:{}", unix_path);
+}
 
 SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler)
 	: WireBase(scheduler), id(std::move(id)), scheduler(scheduler), lifetimeDef(parentLifetime)
@@ -41,6 +72,8 @@ SocketWire::Base::~Base()
 
 void SocketWire::Base::receiverProc() const
 {
+	// [receive_pkg] ends and begins a batch around reading each package, the guard ends the last one
+	MessageBroker::BatchGuard batch_guard(message_broker);
 	while (!lifetimeDef.lifetime->is_terminated())
 	{
 		try
@@ -74,12 +107,22 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 
-		int32_t msglen = static_cast<int32_t>(msg.size());
+		if (!readable_by_counterpart(msg))
+		{
+			logger->error("{}: package {} was written for the previous counterpart, it's dropped", this->id, seqn);
+			return true;
+		}
+
+		int32_t header_length = 0;
+		Buffer::ByteArray const& payload = compress_package(msg, 0, header_length);
+		int32_t msglen = static_cast<int32_t>(payload.size());
 
 		send_package_header.rewind();
-		send_package_header.write_integral(msglen);
+		send_package_header.write_integral(header_length);
 		send_package_header.write_integral(seqn);
 
+		metrics.on_package_sent(seqn, PACKAGE_HEADER_LENGTH + msglen);
+
 		RD_ASSERT_THROW_MSG(
 			socket_provider->Send(send_package_header.data(), send_package_header.get_position()) == PACKAGE_HEADER_LENGTH,
 			this->id +
@@ -87,11 +130,11 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 				", reason: " +
 				socket_provider->DescribeError())
 
-		RD_ASSERT_THROW_MSG(socket_provider->Send(msg.data(), msglen) == msglen, this->id +
+		RD_ASSERT_THROW_MSG(socket_provider->Send(payload.data(), msglen) == msglen, this->id +
 																					 ": failed to send package over the network"
 																					 ", reason: " +
 																					 socket_provider->DescribeError());
-		logger->info("{}: were sent {} bytes", this->id, msglen);
+		logger->trace("{}: were sent {} bytes", this->id, msglen);
 		//        RD_ASSERT_MSG(socketProvider->Flush(), "{}: failed to flush");
 		return true;
 	}
@@ -103,22 +146,281 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 	}
 }
 
-void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+bool SocketWire::Base::send_batch0(Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn) const
 {
-	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
+	try
+	{
+		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+
+		size_t total = 0;
+		send_batch_buffer.rewind();
+		send_batch_payloads.resize(count);
+		// packages the counterpart doesn't read are skipped, [written] counts the rest
+		size_t written = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const sequence_number_t seqn = first_seqn + static_cast<sequence_number_t>(i);
+			if (!readable_by_counterpart(*packages[i]))
+			{
+				logger->error("{}: package {} was written for the previous counterpart, it's dropped", this->id, seqn);
+				continue;
+			}
+			int32_t header_length = 0;
+			send_batch_payloads[written] = &compress_package(*packages[i], written, header_length);
+			send_batch_buffer.write_integral(header_length);
+			send_batch_buffer.write_integral(seqn);
+#if defined(_WIN32)
+			// winsock has no writev, coalesce header and payload of each package into a staging buffer instead
+			send_batch_buffer.write_byte_array_raw(*send_batch_payloads[written]);
+#endif
+			total += PACKAGE_HEADER_LENGTH + send_batch_payloads[written]->size();
+			metrics.on_package_sent(seqn, PACKAGE_HEADER_LENGTH + send_batch_payloads[written]->size());
+			++written;
+		}
+
+#if defined(_WIN32)
+		RD_ASSERT_THROW_MSG(socket_provider->Send(send_batch_buffer.data(), total) == static_cast<int32_t>(total),
+			this->id +
+				": failed to send batch over the network"
+				", reason: " +
+				socket_provider->DescribeError())
+#else
+		// headers are laid out one after another in the staging buffer, each followed by its payload on the wire
+		send_batch_vectors.resize(2 * written);
+		for (size_t i = 0; i < written; ++i)
+		{
+			send_batch_vectors[2 * i].iov_base = send_batch_buffer.data() + i * PACKAGE_HEADER_LENGTH;
+			send_batch_vectors[2 * i].iov_len = PACKAGE_HEADER_LENGTH;
+			send_batch_vectors[2 * i + 1].iov_base = const_cast<Buffer::word_t*>(send_batch_payloads[i]->data());
+			send_batch_vectors[2 * i + 1].iov_len = send_batch_payloads[i]->size();
+		}
+
+		// writev may send less than requested, continue from the first incompletely sent buffer
+		iovec* current = send_batch_vectors.data();
+		iovec* end = send_batch_vectors.data() + send_batch_vectors.size();
+		size_t rest = total;
+		while (rest > 0)
+		{
+			int32_t sent = socket_provider->Send(current, static_cast<int32_t>(end - current));
+			RD_ASSERT_THROW_MSG(sent > 0, this->id +
+											  ": failed to send batch over the network"
+											  ", reason: " +
+											  socket_provider->DescribeError())
+			rest -= sent;
+			size_t skip = static_cast<size_t>(sent);
+			while (current != end && skip >= current->iov_len)
+			{
+				skip -= current->iov_len;
+				++current;
+			}
+			if (current != end)
+			{
+				current->iov_base = static_cast<Buffer::word_t*>(current->iov_base) + skip;
+				current->iov_len -= skip;
+			}
+		}
+#endif
+		logger->trace("{}: were sent {} bytes in {} packages", this->id, total, written);
+		return true;
+	}
+	catch (std::exception const& e)
+	{
+		logger->warn("Send batch failed due to: | {}", e.what());
+		return false;
+	}
+}
 
-	Buffer local_send_buffer;
-	local_send_buffer.write_integral<int32_t>(0);	 // placeholder for length
-	rd_id.write(local_send_buffer);					 // write id
-	local_send_buffer.write_integral<int16_t>(0);	 // placeholder for context
-	writer(local_send_buffer);						 // write rest
+void SocketWire::Base::set_max_send_batch_size(size_t value)
+{
+	async_send_buffer.set_max_batch_size(value);
+}
 
-	int32_t len = static_cast<int32_t>(local_send_buffer.get_position());
+Buffer::ByteArray const& SocketWire::Base::compress_package(
+	Buffer::ByteArray const& package, size_t slot, int32_t& header_length) const
+{
+	header_length = static_cast<int32_t>(package.size());
+	const size_t threshold = compression_threshold.load(std::memory_order_relaxed);
+	if (threshold == 0 || package.size() < threshold || !counterpart_decompresses.load(std::memory_order_relaxed))
+	{
+		return package;
+	}
+
+	if (compression_buffers.size() <= slot)
+	{
+		compression_buffers.resize(slot + 1);
+	}
+	Buffer::ByteArray& compressed = compression_buffers[slot];
+	compressed.resize(sizeof(int32_t) + util::lz_compress_bound(package.size()));
+	const int32_t original_length = header_length;
+	memcpy(compressed.data(), &original_length, sizeof(original_length));
+	const size_t compressed_size = util::lz_compress(
+		package.data(), package.size(), compressed.data() + sizeof(int32_t), compressed.size() - sizeof(int32_t));
+	if (compressed_size == 0 || sizeof(int32_t) + compressed_size >= package.size())
+	{
+		return package;
+	}
+	compressed.resize(sizeof(int32_t) + compressed_size);
 
-	local_send_buffer.rewind();
-	local_send_buffer.write_integral<int32_t>(len - 4);
-	local_send_buffer.set_position(len);
-	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
+	compressed_packages.fetch_add(1, std::memory_order_relaxed);
+	compressed_bytes_before.fetch_add(package.size(), std::memory_order_relaxed);
+	compressed_bytes_after.fetch_add(compressed.size(), std::memory_order_relaxed);
+
+	header_length = static_cast<int32_t>(compressed.size()) | COMPRESSED_PACKAGE_FLAG;
+	return compressed;
+}
+
+bool SocketWire::Base::readable_by_counterpart(Buffer::ByteArray const& package) const
+{
+	if (!negotiated_messages_written.load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+	// a package holds a single message, its length comes first
+	int32_t len = 0;
+	memcpy(&len, package.data(), sizeof(len));
+	return ((len & COMPACT_MESSAGE_FLAG) == 0 || counterpart_reads_compact.load(std::memory_order_relaxed)) &&
+		   ((len & FRAGMENT_FLAGS) == 0 || counterpart_reassembles.load(std::memory_order_relaxed));
+}
+
+void SocketWire::Base::resume_sending() const
+{
+	sending_resumed = true;
+	async_send_buffer.resume();
+}
+
+WireMetrics::Snapshot SocketWire::Base::get_metrics() const
+{
+	WireMetrics::Snapshot snapshot = metrics.snapshot();
+	snapshot.queued_packages = async_send_buffer.get_queue_depth();
+	const RetransmitWindow::Stats pending = async_send_buffer.get_retransmit_stats();
+	snapshot.pending_packages = pending.retained_packages;
+	snapshot.pending_bytes = pending.retained_bytes;
+	return snapshot;
+}
+
+void SocketWire::Base::start_metrics_export(
+	Lifetime lifetime, std::chrono::milliseconds period, std::function<void(WireMetrics::Snapshot const&)> sink) const
+{
+	TimerWheel::Instance().schedule(
+		lifetime, period,
+		[this, sink] {
+			const WireMetrics::Snapshot snapshot = get_metrics();
+			if (sink)
+			{
+				sink(snapshot);
+			}
+			else
+			{
+				logger->info("{}: {}", this->id, to_string(snapshot));
+			}
+		},
+		period);
+}
+
+void SocketWire::Base::set_compression_threshold(size_t value)
+{
+	compression_threshold.store(value, std::memory_order_relaxed);
+}
+
+void SocketWire::Base::set_compact_encoding(bool value)
+{
+	compact_encoding.store(value, std::memory_order_relaxed);
+}
+
+SocketWire::Base::CompressionStats SocketWire::Base::get_compression_stats() const
+{
+	return CompressionStats{compressed_packages.load(std::memory_order_relaxed),
+		compressed_bytes_before.load(std::memory_order_relaxed), compressed_bytes_after.load(std::memory_order_relaxed)};
+}
+
+void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const
+{
+	const bool compact = compact_encoding.load(std::memory_order_relaxed) &&
+						 counterpart_reads_compact.load(std::memory_order_relaxed) && capabilities_announced.load();
+	if (compact)
+	{
+		negotiated_messages_written = true;
+	}
+	async_send_buffer.put(write_message(rd_id, writer, size_hint,
+		compact ? Buffer::IntegralEncoding::Compact : Buffer::IntegralEncoding::Fixed, COMPACT_MESSAGE_FLAG));
+}
+
+void SocketWire::Base::send_fragmented(
+	RdId const& rd_id, std::function<void(Buffer& buffer, std::function<void()> const& flush)> writer) const
+{
+	if (!counterpart_reassembles.load(std::memory_order_relaxed) || !capabilities_announced.load())
+	{
+		// the counterpart reads every message from a single frame
+		WireBase::send_fragmented(rd_id, std::move(writer));
+		return;
+	}
+	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
+
+	std::lock_guard<decltype(fragmented_send_lock)> guard(fragmented_send_lock);
+
+	const bool compact =
+		compact_encoding.load(std::memory_order_relaxed) && counterpart_reads_compact.load(std::memory_order_relaxed);
+	Buffer fragment;
+	size_t payload_start = 0;
+	const auto start_fragment = [&] {
+		fragment = Buffer(BufferPool::Instance().acquire(FRAGMENT_SIZE));
+		fragment.write_integral<int32_t>(0);	// placeholder for length
+		rd_id.write(fragment);					// write id
+		payload_start = fragment.get_position();
+		if (compact)
+		{
+			fragment.set_integral_encoding(Buffer::IntegralEncoding::Compact);
+		}
+	};
+	const auto put_fragment = [&](int32_t fragment_flags) {
+		int32_t len = static_cast<int32_t>(fragment.get_position());
+		const int32_t flags =
+			(fragment.get_integral_encoding() == Buffer::IntegralEncoding::Compact ? COMPACT_MESSAGE_FLAG : 0) | fragment_flags;
+		if (flags != 0)
+		{
+			negotiated_messages_written = true;
+		}
+
+		fragment.rewind();
+		fragment.write_integral<int32_t>((len - 4) | flags);
+		fragment.set_position(len);
+		async_send_buffer.put(std::move(fragment).getRealArray());
+	};
+
+	bool first = true;
+	bool dropped = false;
+	start_fragment();
+	fragment.write_integral<int16_t>(0);	// placeholder for context
+	writer(fragment, [&] {
+		if (dropped)
+		{
+			// let the writer run to completion in the same buffer
+			fragment.set_position(payload_start);
+			return;
+		}
+		if (fragment.get_position() < FRAGMENT_SIZE)
+		{
+			return;
+		}
+		put_fragment(first ? FRAGMENT_FLAGS : FRAGMENT_MESSAGE_FLAG);
+		first = false;
+		// don't get ahead of the socket, fragments stay bounded while the wire is disconnected too.
+		// Only termination gives up on the message
+		while (!async_send_buffer.wait_queue_depth(MAX_QUEUED_FRAGMENTS, timeout))
+		{
+			if (lifetimeDef.lifetime->is_terminated())
+			{
+				logger->warn("{}: fragmented message {} is dropped, wire is terminated", this->id, rd_id.get_hash());
+				dropped = true;
+				break;
+			}
+		}
+		start_fragment();
+	});
+	if (!dropped)
+	{
+		put_fragment(first ? 0 : LAST_FRAGMENT_FLAG);
+	}
 }
 
 void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_socket)
@@ -126,8 +428,16 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 		socket_provider = std::move(new_socket);
+		// the counterpart announces compression support again with its pings
+		counterpart_decompresses = false;
+		counterpart_reads_compact = false;
+		counterpart_reassembles = false;
+		capabilities_announced = false;
 		socket_send_var.notify_all();
 	}
+	// the receiver thread is the caller, messages of the previous connection won't be completed
+	fragments.clear();
+	reassembled_bytes = 0;
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
 		if (lifetimeDef.lifetime->is_terminated())
@@ -136,24 +446,34 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 		}
 	}
 
-	auto heartbeat = LifetimeDefinition::use([this](Lifetime heartbeatLifetime) {
-		const auto heartbeat = start_heartbeat(heartbeatLifetime).share();
+	LifetimeDefinition::use([this](Lifetime heartbeatLifetime) {
+		// announce the capabilities right away rather than after the heartbeat interval
+		ping();
+		start_heartbeat(heartbeatLifetime);
 
-		async_send_buffer.resume();
+		// retained packages may depend on the capabilities of the previous counterpart, they are replayed
+		// once the PING of the new one tells whether it reads them
+		sending_resumed = false;
+		if (!negotiated_messages_written.load())
+		{
+			resume_sending();
+		}
 
+		metrics.on_connected();
 		connected.set(true);
 
 		receiverProc();
 
 		connected.set(false);
+		metrics.on_disconnected();
 
-		async_send_buffer.pause("Disconnected");
-
-		return heartbeat;
+		if (sending_resumed)
+		{
+			async_send_buffer.pause("Disconnected");
+		}
 	});
-	const auto status = heartbeat.wait_for(timeout);
 
-	logger->debug("{}: waited for heartbeat to stop with status: {}", this->id, static_cast<uint32_t>(status));
+	logger->debug("{}: heartbeat stopped", this->id);
 
 	if (!socket_provider->IsSocketValid())
 	{
@@ -171,15 +491,34 @@ bool SocketWire::Base::connection_established(int32_t timestamp, int32_t notion_
 	return timestamp - notion_timestamp <= MaximumHeartbeatDelay;
 }
 
-std::future<void> SocketWire::Base::start_heartbeat(Lifetime lifetime)
+void SocketWire::Base::start_heartbeat(Lifetime lifetime)
+{
+	// the timer is cancelled on termination of [lifetime], which also waits for a ping in progress
+	TimerWheel::Instance().schedule(lifetime, heartBeatInterval, [this] { ping(); }, heartBeatInterval);
+}
+
+int32_t SocketWire::Base::receive_from_socket(Buffer::word_t* dst, int32_t max_len) const
 {
-	return std::async([this, lifetime] {
-		while (!lifetime->is_terminated())
+	logger->trace("{}: receive started", this->id);
+	int32_t read = socket_provider->Receive(max_len, dst);
+	if (read == -1)
+	{
+		auto err = socket_provider->GetSocketError();
+		if (err == CSimpleSocket::SocketInvalidSocket)
 		{
-			std::this_thread::sleep_for(heartBeatInterval);
-			ping();
+			logger->info("{}: socket was shut down for receiving", this->id);
+			return -1;
 		}
-	});
+		logger->error("{}: error has occurred while receiving", this->id);
+		return -1;
+	}
+	if (read == 0)
+	{
+		logger->info("{}: socket was shut down for receiving", this->id);
+		return 0;
+	}
+	logger->trace("{}: receive finished: {} bytes read", this->id, read);
+	return read;
 }
 
 bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) const
@@ -199,35 +538,28 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 			lo += copylen;
 			ptr += copylen;
 		}
+		else if (rest >= DIRECT_RECEIVE_THRESHOLD)
+		{
+			// nothing is buffered and the destination is large enough, avoid copying through receiver_buffer
+			int32_t read = receive_from_socket(res + ptr, rest);
+			if (read <= 0)
+			{
+				return false;
+			}
+			ptr += read;
+		}
 		else
 		{
 			if (hi == receiver_buffer.end())
 			{
 				hi = lo = receiver_buffer.begin();
 			}
-			logger->info("{}: receive started", this->id);
-			int32_t read = socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
-			if (read == -1)
-			{
-				auto err = socket_provider->GetSocketError();
-				if (err == CSimpleSocket::SocketInvalidSocket)
-				{
-					logger->info("{}: socket was shut down for receiving", this->id);
-					return false;
-				}
-				logger->error("{}: error has occurred while receiving", this->id);
-				return false;
-			}
-			if (read == 0)
+			int32_t read = receive_from_socket(&*hi, static_cast<int32_t>(receiver_buffer.end() - hi));
+			if (read <= 0)
 			{
-				logger->info("{}: socket was shut down for receiving", this->id);
 				return false;
 			}
 			hi += read;
-			if (read > 0)
-			{
-				logger->info("{}: receive finished: {} bytes read", this->id, read);
-			}
 		}
 	}
 	if (ptr != msglen)
@@ -263,8 +595,16 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 				return INVALID_HEADER;
 			}
 
-			counterpart_timestamp = received_timestamp;
-			counterpart_acknowledge_timestamp = received_counterpart_timestamp;
+			counterpart_decompresses = (received_timestamp & COMPRESSION_CAPABILITY_FLAG) != 0;
+			counterpart_reads_compact = (received_timestamp & COMPACT_ENCODING_CAPABILITY_FLAG) != 0;
+			counterpart_reassembles = (received_timestamp & FRAGMENT_CAPABILITY_FLAG) != 0;
+			counterpart_timestamp = received_timestamp & ~CAPABILITY_FLAGS;
+			counterpart_acknowledge_timestamp = received_counterpart_timestamp & ~CAPABILITY_FLAGS;
+			metrics.on_ping_acknowledged(counterpart_acknowledge_timestamp);
+			if (!sending_resumed && capabilities_announced.load())
+			{
+				resume_sending();
+			}
 
 			if ((connection_established(current_timestamp, counterpart_acknowledge_timestamp)))
 			{
@@ -291,6 +631,7 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 
 		if (len == ACK_MESSAGE_LENGTH)
 		{
+			metrics.on_acknowledged(seqn);
 			async_send_buffer.acknowledge(seqn);
 			continue;
 		}
@@ -300,34 +641,79 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 
 int32_t SocketWire::Base::read_package() const
 {
-	receive_pkg.rewind();
-
-	const auto pair = read_header();
-	if (pair == INVALID_HEADER)
+	while (true)
 	{
-		logger->debug("{}: failed to read header", this->id);
-		return -1;
-	}
-	const auto len = pair.first;
-	const auto seqn = pair.second;
+		receive_pkg.rewind();
 
-	logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+		const auto pair = read_header();
+		if (pair == INVALID_HEADER)
+		{
+			logger->debug("{}: failed to read header", this->id);
+			return -1;
+		}
+		auto len = pair.first;
+		const auto seqn = pair.second;
 
-	receive_pkg.require_available(len);
-	if (!read_data_from_socket(receive_pkg.data(), len))
-	{
-		logger->debug("{}: failed to read package", this->id);
-		return -1;
-	}
-	send_ack(seqn);
-	if (seqn <= max_received_seqn && seqn != 1)
-	{
-		return true;
-	}
-	max_received_seqn = seqn;
+		logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+		metrics.on_package_received(PACKAGE_HEADER_LENGTH + (len & ~COMPRESSED_PACKAGE_FLAG));
+
+		if ((len & COMPRESSED_PACKAGE_FLAG) != 0)
+		{
+			len &= ~COMPRESSED_PACKAGE_FLAG;
+			if (len > MAX_PACKAGE_SIZE)
+			{
+				logger->error("{}: malformed compressed package length {}, seqn={}", this->id, len, seqn);
+				return -1;
+			}
+			if (decompression_buffer.size() < static_cast<size_t>(len))
+			{
+				decompression_buffer.resize(len);
+			}
+			if (!read_data_from_socket(decompression_buffer.data(), len))
+			{
+				logger->debug("{}: failed to read package", this->id);
+				return -1;
+			}
+			int32_t original_length = -1;
+			if (len >= static_cast<int32_t>(sizeof(original_length)))
+			{
+				memcpy(&original_length, decompression_buffer.data(), sizeof(original_length));
+			}
+			// the length comes from the counterpart, it's validated before anything is allocated for it
+			if (original_length < 0 || original_length > MAX_PACKAGE_SIZE)
+			{
+				logger->error("{}: malformed compressed package, seqn={}", this->id, seqn);
+				return -1;
+			}
+			receive_pkg.require_available(original_length);
+			if (!util::lz_decompress(decompression_buffer.data() + sizeof(original_length), len - sizeof(original_length),
+					receive_pkg.data(), original_length))
+			{
+				logger->error("{}: failed to decompress package, seqn={}", this->id, seqn);
+				return -1;
+			}
+			len = original_length;
+		}
+		else
+		{
+			receive_pkg.require_available(len);
+			if (!read_data_from_socket(receive_pkg.data(), len))
+			{
+				logger->debug("{}: failed to read package", this->id);
+				return -1;
+			}
+		}
+		send_ack(seqn);
+		if (seqn <= max_received_seqn && seqn != 1)
+		{
+			// already received before reconnect, skip it
+			continue;
+		}
+		max_received_seqn = seqn;
 
-	logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
-	return len;
+		logger->trace("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+		return len;
+	}
 }
 
 bool SocketWire::Base::read_and_dispatch_message() const
@@ -346,22 +732,95 @@ bool SocketWire::Base::read_and_dispatch_message() const
 	}
 	logger->trace("{}: message info: sz={}, id={}", this->id, sz, id_);
 	const RdId rd_id{id_};
+	// flags are only decoded from a counterpart which announced them, the bits may belong to a plain length
+	const int32_t negotiated_flags = (counterpart_reads_compact.load(std::memory_order_relaxed) ? COMPACT_MESSAGE_FLAG : 0) |
+									 (counterpart_reassembles.load(std::memory_order_relaxed) ? FRAGMENT_FLAGS : 0);
+	const int32_t flags = sz & negotiated_flags;
+	const Buffer::IntegralEncoding encoding =
+		(flags & COMPACT_MESSAGE_FLAG) != 0 ? Buffer::IntegralEncoding::Compact : Buffer::IntegralEncoding::Fixed;
+	sz &= ~negotiated_flags;
 	sz -= 8;	// RdId
-	message.require_available(sz);
 
-	if (!receive_pkg.read(message.data() + message.get_position(), sz - message.get_position()))
+	// fragments of a message are collected until the last one
+	if ((flags & FRAGMENT_FLAGS) != 0)
 	{
-		logger->error("{}: constructing message failed", this->id);
-		return false;
+		auto it = fragments.find(id_);
+		if ((flags & FRAGMENT_FLAGS) == FRAGMENT_FLAGS)
+		{
+			// the first fragment, a message interrupted by a restart of the counterpart is discarded
+			if (it == fragments.end())
+			{
+				it = fragments.emplace(id_, Buffer::ByteArray()).first;
+			}
+			reassembled_bytes -= it->second.size();
+			it->second.clear();
+		}
+		if (it == fragments.end())
+		{
+			// the beginning was sent over a previous connection
+			logger->error("{}: fragment of message {} without its beginning is dropped", this->id, id_);
+			Buffer::ByteArray skipped(sz);
+			if (!receive_pkg.read(skipped.data(), sz))
+			{
+				logger->error("{}: constructing message failed", this->id);
+				return false;
+			}
+		}
+		else
+		{
+			Buffer::ByteArray& message = it->second;
+			if (fragments.size() > MAX_REASSEMBLED_MESSAGES || reassembled_bytes + sz > MAX_REASSEMBLED_BYTES)
+			{
+				logger->error("{}: too many fragmented messages in progress: {} messages, {} bytes", this->id,
+					fragments.size(), reassembled_bytes + sz);
+				return false;
+			}
+			const size_t received = message.size();
+			message.resize(received + sz);
+			reassembled_bytes += sz;
+			if (!receive_pkg.read(message.data() + received, sz))
+			{
+				logger->error("{}: constructing message failed", this->id);
+				return false;
+			}
+			if ((flags & FRAGMENT_FLAGS) == LAST_FRAGMENT_FLAG)
+			{
+				reassembled_bytes -= message.size();
+				Buffer assembled(std::move(message));
+				fragments.erase(it);
+				logger->debug("{}: message received", this->id);
+				assembled.set_integral_encoding(encoding);
+				message_broker.dispatch(rd_id, std::move(assembled));
+			}
+		}
+	}
+	else
+	{
+		// a message which lies within a single package is dispatched as a view over it, otherwise it's assembled
+		optional<Buffer> view = receive_pkg.try_read_view(sz);
+		if (view)
+		{
+			logger->debug("{}: message received", this->id);
+			view->set_integral_encoding(encoding);
+			message_broker.dispatch(rd_id, *std::move(view));
+		}
+		else
+		{
+			Buffer message(sz);
+			if (!receive_pkg.read(message.data(), sz))
+			{
+				logger->error("{}: constructing message failed", this->id);
+				return false;
+			}
+			logger->debug("{}: message received", this->id);
+			message.set_integral_encoding(encoding);
+			message_broker.dispatch(rd_id, std::move(message));
+		}
 	}
-
-	logger->debug("{}: message received", this->id);
-	message_broker.dispatch(rd_id, std::move(message));
 	logger->debug("{}: message dispatched", this->id);
 
 	sz = -1;
 	id_ = -1;
-	message.rewind();
 	return true;
 	//		RD_ASSERT_MSG(summary_size == sz, "Broken message, read:%d bytes, expected:%d bytes", summary_size, sz)
 }
@@ -371,6 +830,24 @@ CSimpleSocket* SocketWire::Base::get_socket_provider() const
 	return socket_provider.get();
 }
 
+/**
+ * \brief Whether [socket] takes a few more bytes right away, without waiting for the counterpart to read.
+ */
+static bool is_writable(SOCKET socket)
+{
+#if defined(_WIN32)
+	fd_set write_fds;
+	FD_ZERO(&write_fds);
+	FD_SET(socket, &write_fds);
+	timeval timeout{0, 0};
+	return ::select(0, nullptr, &write_fds, nullptr, &timeout) > 0;
+#else
+	// poll rather than select, descriptors of a big process may exceed FD_SETSIZE
+	pollfd fd{socket, POLLOUT, 0};
+	return ::poll(&fd, 1, 0) > 0 && (fd.revents & POLLOUT) != 0;
+#endif
+}
+
 void SocketWire::Base::ping() const
 {
 	if (!connection_established(current_timestamp, counterpart_acknowledge_timestamp))
@@ -389,10 +866,16 @@ void SocketWire::Base::ping() const
 	try
 	{
 		ping_pkg_header.set_position(sizeof(PING_MESSAGE_LENGTH));
-		ping_pkg_header.write_integral(current_timestamp);
+		ping_pkg_header.write_integral(current_timestamp | CAPABILITY_FLAGS);
 		ping_pkg_header.write_integral(counterpart_timestamp);
 		{
-			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+			// pings of all wires share the timer wheel thread, so neither wait for a send in progress nor for a counterpart
+			// which doesn't read, skip this beat instead
+			std::unique_lock<decltype(socket_send_lock)> guard(socket_send_lock, std::try_to_lock);
+			if (!guard.owns_lock() || !is_writable(socket_provider->GetSocketDescriptor()))
+			{
+				return;
+			}
 			int32_t sent = socket_provider->Send(ping_pkg_header.data(), ping_pkg_header.get_position());
 			if (sent == 0 && !socket_provider->IsSocketValid())
 			{
@@ -401,7 +884,9 @@ void SocketWire::Base::ping() const
 			}
 			RD_ASSERT_THROW_MSG(sent == PACKAGE_HEADER_LENGTH,
 				fmt::format("{}: failed to send ping over the network, reason: {}", this->id, socket_provider->DescribeError()))
+			capabilities_announced = true;
 		}
+		metrics.on_ping_sent(current_timestamp);
 
 		++current_timestamp;
 	}
@@ -446,35 +931,60 @@ bool SocketWire::Base::try_shutdown_connection() const
 }
 
 SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
-	: Base(id, parentLifetime, scheduler), port(port), clientLifetimeDefinition(parentLifetime)
+	: Client(parentLifetime, scheduler, port, std::string(), id)
+{
+}
+
+SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, std::string unix_path, const std::string& id)
+	: Client(parentLifetime, scheduler, 0, std::move(unix_path), id)
+{
+}
+
+SocketWire::Client::Client(
+	Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, std::string unix_path, const std::string& id)
+	: Base(id, parentLifetime, scheduler), port(port), unix_path(std::move(unix_path)), clientLifetimeDefinition(parentLifetime)
 {
 	Lifetime lifetime = clientLifetimeDefinition.lifetime;
 	thread = std::thread([this, lifetime]() mutable {
 		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Client Thread" : this->id.c_str());
 
+		const std::string endpoint = describe_endpoint(this->port, this->unix_path);
 		try
 		{
-			logger->info("{}: started, port: {}.", this->id, this->port);
+			logger->info("{}: started, endpoint: {}.", this->id, endpoint);
 
 			while (!lifetime->is_terminated())
 			{
 				try
 				{
-					socket = std::make_shared<CActiveSocket>();
-					RD_ASSERT_THROW_MSG(socket->Initialize(),
-						fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, socket->DescribeError()));
-					RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
-						fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, socket->DescribeError()));
-
-					// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
-					// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket any
-					// moment.
-
-					// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
-					// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
-					logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
-					RD_ASSERT_THROW_MSG(socket->Open("127.0.0.1", this->port),
-						fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, socket->DescribeError()));
+					if (this->unix_path.empty())
+					{
+						socket = std::make_shared<CActiveSocket>();
+						RD_ASSERT_THROW_MSG(socket->Initialize(),
+							fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, socket->DescribeError()));
+						RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
+							fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, socket->DescribeError()));
+
+						// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
+						// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket
+						// any moment.
+
+						// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
+						// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
+						logger->info("{}: connecting {}", this->id, endpoint);
+						RD_ASSERT_THROW_MSG(socket->Open("127.0.0.1", this->port),
+							fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, socket->DescribeError()));
+					}
+					else
+					{
+						// local stream socket, there is no Nagle's algorithm to disable
+						socket = std::make_shared<CActiveSocket>(CSimpleSocket::SocketTypeUnix);
+						RD_ASSERT_THROW_MSG(socket->Initialize(),
+							fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, socket->DescribeError()));
+						logger->info("{}: connecting {}", this->id, endpoint);
+						RD_ASSERT_THROW_MSG(socket->OpenUnix(this->unix_path.c_str()),
+							fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, socket->DescribeError()));
+					}
 					{
 						std::lock_guard<decltype(lock)> guard(lock);
 						if (lifetime->is_terminated())
@@ -491,14 +1001,25 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 				}
 				catch (std::exception const& e)
 				{
-					logger->debug("{}: connection error for port {} ({}).", this->id, this->port, e.what());
+					logger->debug("{}: connection error for {} ({}).", this->id, endpoint, e.what());
 
-					std::lock_guard<decltype(lock)> guard(lock);
+					std::unique_lock<decltype(lock)> guard(lock);
 					bool should_reconnect = false;
 					if (!lifetime->is_terminated())
 					{
-						cv.wait_for(lock, timeout);
+						// back off until the timer elapses or the wire is terminated
+						bool elapsed = false;
+						const auto timer = TimerWheel::Instance().schedule(timeout, [this, &elapsed] {
+							{
+								std::lock_guard<decltype(lock)> elapsed_guard(lock);
+								elapsed = true;
+							}
+							cv.notify_all();
+						});
+						cv.wait(guard, [&elapsed, &lifetime] { return elapsed || lifetime->is_terminated(); });
 						should_reconnect = !lifetime->is_terminated();
+						guard.unlock();
+						TimerWheel::Instance().cancel(timer);
 					}
 					if (should_reconnect)
 					{
@@ -512,7 +1033,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		{
 			logger->info("{}: closed with exception: {}", this->id, e.what());
 		}
-		logger->info("{}: terminated, port: {}.", this->id, this->port);
+		logger->info("{}: terminated, endpoint: {}.", this->id, endpoint);
 	});
 
 	lifetime->add_action([this]() {
@@ -551,25 +1072,88 @@ SocketWire::Client::~Client()
 }
 
 SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
-	: Base(id, parentLifetime, scheduler), ss(std::make_unique<CPassiveSocket>()), serverLifetimeDefinition(parentLifetime)
+	: Server(parentLifetime, scheduler, open_listening(port, std::string(), id), std::string(), id)
+{
+}
+
+SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, std::string unix_path, const std::string& id)
+	: Server(parentLifetime, scheduler, open_listening(0, unix_path, id), unix_path, id)
+{
+}
+
+std::shared_ptr<SocketWire::Server> SocketWire::Server::create_unix(
+	Lifetime lifetime, IScheduler* scheduler, std::string unix_path, const std::string& id)
+{
+	std::unique_ptr<CPassiveSocket> listening = open_listening(0, unix_path, id);
+	if (listening == nullptr)
+	{
+		return nullptr;
+	}
+	return std::shared_ptr<Server>(new Server(std::move(lifetime), scheduler, std::move(listening), std::move(unix_path), id));
+}
+
+std::unique_ptr<CPassiveSocket> SocketWire::Server::open_listening(
+	uint16_t port, std::string const& unix_path, const std::string& id)
 {
 #ifdef SIGPIPE
 	signal(SIGPIPE, SIG_IGN);
 #endif
-	RD_ASSERT_MSG(ss->Initialize(), fmt::format("{}: failed to initialize socket, reason: {}", this->id, socket->DescribeError()));
-	RD_ASSERT_MSG(ss->Listen("127.0.0.1", port),
-		fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, std::to_string(port), ss->DescribeError()));
-
-	this->port = ss->GetServerPort();
-	RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
+	auto listening = std::make_unique<CPassiveSocket>(unix_path.empty() ? CSimpleSocket::SocketTypeTcp : CSimpleSocket::SocketTypeUnix);
+	if (!listening->Initialize())
+	{
+		logger->warn("{}: failed to initialize socket, reason: {}", id, listening->DescribeError());
+		return nullptr;
+	}
+	if (unix_path.empty())
+	{
+		if (!listening->Listen("127.0.0.1", port))
+		{
+			logger->warn("{}: failed to listen socket on port: {}, reason: {}", id, port, listening->DescribeError());
+			return nullptr;
+		}
+	}
+	else
+	{
+		// a file left by a crashed process would make bind fail
+		std::remove(unix_path.c_str());
+		if (!listening->ListenUnix(unix_path.c_str()))
+		{
+			logger->warn("{}: failed to listen socket on path: {}, reason: {}", id, unix_path, listening->DescribeError());
+			return nullptr;
+		}
+	}
+	return listening;
+}
 
-	logger->info("{}: listening 127.0.0.1/{}", this->id, this->port);
+SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, std::unique_ptr<CPassiveSocket> listening,
+	std::string unix_path, const std::string& id)
+	: Base(id, parentLifetime, scheduler)
+	, unix_path(std::move(unix_path))
+	, ss(std::move(listening))
+	, serverLifetimeDefinition(parentLifetime)
+{
 	Lifetime lifetime = serverLifetimeDefinition.lifetime;
+	if (ss == nullptr)
+	{
+		RD_ASSERT_MSG(false, fmt::format("{}: failed to listen {}", this->id, describe_endpoint(0, this->unix_path)));
+		// nothing to accept on, the wire stays disconnected
+		ss = std::make_unique<CPassiveSocket>();
+		lifetime->add_action([this] { async_send_buffer.stop(timeout); });
+		return;
+	}
+	if (this->unix_path.empty())
+	{
+		this->port = ss->GetServerPort();
+		RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
+	}
+
+	logger->info("{}: listening {}", this->id, describe_endpoint(this->port, this->unix_path));
 
 	thread = std::thread([this, lifetime]() mutable {
 		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Server Thread" : this->id.c_str());
 
-		logger->info("{}: started, port: {}.", this->id, this->port);
+		const std::string endpoint = describe_endpoint(this->port, this->unix_path);
+		logger->info("{}: started, endpoint: {}.", this->id, endpoint);
 
 		try
 		{
@@ -589,9 +1173,16 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 					RD_ASSERT_THROW_MSG(
 						accepted != nullptr, fmt::format("{}: accepting failed, reason: {}", this->id, ss->DescribeError()));
 					socket.reset(accepted);
-					logger->info("{}: accepted passive socket {}/{}", this->id, socket->GetClientAddr(), socket->GetClientPort());
-					RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
-						fmt::format("{}: tcpNoDelay failed, reason: {}", this->id, socket->DescribeError()));
+					if (this->unix_path.empty())
+					{
+						logger->info("{}: accepted passive socket {}/{}", this->id, socket->GetClientAddr(), socket->GetClientPort());
+						RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
+							fmt::format("{}: tcpNoDelay failed, reason: {}", this->id, socket->DescribeError()));
+					}
+					else
+					{
+						logger->info("{}: accepted passive socket on {}", this->id, endpoint);
+					}
 
 					{
 						std::lock_guard<decltype(lock)> guard(lock);
@@ -620,7 +1211,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 			logger->error("{}: terminal socket error ({}).", this->id, e.what());
 		}
 
-		logger->info("{}: terminated, port: {}.", this->id, this->port);
+		logger->info("{}: terminated, endpoint: {}.", this->id, endpoint);
 	});
 
 	lifetime->add_action([this] {
@@ -634,6 +1225,10 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		{
 			logger->error("{}: failed to close server socket", this->id);
 		}
+		if (!this->unix_path.empty())
+		{
+			std::remove(this->unix_path.c_str());
+		}
 
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
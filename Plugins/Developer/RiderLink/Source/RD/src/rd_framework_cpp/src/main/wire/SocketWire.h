@@ -9,11 +9,20 @@
 #include "scheduler/base/IScheduler.h"
 #include "base/WireBase.h"
 #include "ByteBufferAsyncProcessor.h"
+#include "protocol/BufferPool.h"
 #include "PkgInputStream.h"
+#include "WireMetrics.h"
 
 #include <string>
 #include <array>
+#include <atomic>
 #include <condition_variable>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/uio.h>
+#endif
 
 #include <rd_framework_export.h>
 
@@ -46,10 +55,18 @@ public:
 		std::shared_ptr<CActiveSocket> socket;
 
 		mutable std::condition_variable socket_send_var;
+		static constexpr size_t DEFAULT_MAX_SEND_BATCH_SIZE = 64;
+
 		mutable ByteBufferAsyncProcessor async_send_buffer{id + "-AsyncSendProcessor",
-			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); }};
+			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); },
+			[this](Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn) -> bool {
+				return this->send_batch0(packages, count, first_seqn);
+			},
+			DEFAULT_MAX_SEND_BATCH_SIZE};
 
 		static constexpr size_t RECEIVE_BUFFER_SIZE = 1u << 16;
+		// reads at least this large bypass [receiver_buffer] and go directly to the destination
+		static constexpr int32_t DIRECT_RECEIVE_THRESHOLD = 1 << 12;
 		mutable std::array<Buffer::word_t, RECEIVE_BUFFER_SIZE> receiver_buffer{};
 		mutable decltype(receiver_buffer)::iterator lo = receiver_buffer.begin(), hi = receiver_buffer.begin();
 
@@ -58,6 +75,104 @@ public:
 		static constexpr int32_t PACKAGE_HEADER_LENGTH = sizeof(ACK_MESSAGE_LENGTH) + sizeof(sequence_number_t);
 		mutable Buffer ack_buffer{PACKAGE_HEADER_LENGTH};
 
+		/**
+		 * \brief Set in the length of a package header if the package is [int32 original length][compressed block].
+		 */
+		static constexpr int32_t COMPRESSED_PACKAGE_FLAG = 1 << 30;
+		/**
+		 * \brief Set in the timestamp of PING by wires able to decompress packages. Old wires echo it back unchanged
+		 * and never set it themselves, so compression is used only when both sides support it.
+		 */
+		static constexpr int32_t COMPRESSION_CAPABILITY_FLAG = 1 << 30;
+		/**
+		 * \brief Set in the length of a message whose payload is written with Buffer::IntegralEncoding::Compact.
+		 */
+		static constexpr int32_t COMPACT_MESSAGE_FLAG = 1 << 30;
+		/**
+		 * \brief Set in the timestamp of PING by wires able to read compact messages, negotiated like compression.
+		 */
+		static constexpr int32_t COMPACT_ENCODING_CAPABILITY_FLAG = 1 << 29;
+		/**
+		 * \brief Set in the length of the middle fragments of a message sent by \ref send_fragmented. The first fragment
+		 * carries both \ref FRAGMENT_FLAGS, the last one \ref LAST_FRAGMENT_FLAG only, a message which fits a single
+		 * fragment none of them. Fragments of a message may interleave with other messages.
+		 */
+		static constexpr int32_t FRAGMENT_MESSAGE_FLAG = 1 << 29;
+		static constexpr int32_t LAST_FRAGMENT_FLAG = 1 << 28;
+		static constexpr int32_t FRAGMENT_FLAGS = FRAGMENT_MESSAGE_FLAG | LAST_FRAGMENT_FLAG;
+		/**
+		 * \brief Set in the timestamp of PING by wires able to reassemble fragmented messages.
+		 */
+		static constexpr int32_t FRAGMENT_CAPABILITY_FLAG = 1 << 28;
+		static constexpr int32_t CAPABILITY_FLAGS =
+			COMPRESSION_CAPABILITY_FLAG | COMPACT_ENCODING_CAPABILITY_FLAG | FRAGMENT_CAPABILITY_FLAG;
+
+		std::atomic<bool> compact_encoding{false};
+		mutable std::atomic<bool> counterpart_reads_compact{false};
+
+		/**
+		 * \brief Set once the PING with this side's capabilities was sent on the current connection. Messages depending
+		 * on the counterpart's capabilities are written only afterwards, so the counterpart knows to decode them.
+		 */
+		mutable std::atomic<bool> capabilities_announced{false};
+		// set once such a message was written, it may be retained and replayed to the next counterpart
+		mutable std::atomic<bool> negotiated_messages_written{false};
+		// accessed by the receiver thread only, whether the sender was resumed on the current connection
+		mutable bool sending_resumed = false;
+
+		/**
+		 * \brief Payload collected before a fragment is sent, the largest size class of BufferPool.
+		 */
+		static constexpr size_t FRAGMENT_SIZE = BufferPool::MAX_POOLED_SIZE;
+		/**
+		 * \brief A fragmented send waits while more packages are queued, which bounds its memory.
+		 */
+		static constexpr size_t MAX_QUEUED_FRAGMENTS = 16;
+		mutable std::atomic<bool> counterpart_reassembles{false};
+		// fragments of one message must not interleave with fragments of another message to the same id
+		mutable std::mutex fragmented_send_lock;
+		/**
+		 * \brief Bounds of the messages being reassembled at once, a counterpart exceeding them breaks the protocol.
+		 */
+		static constexpr size_t MAX_REASSEMBLED_MESSAGES = 16;
+		static constexpr size_t MAX_REASSEMBLED_BYTES = size_t(1) << 30;
+		// accessed by the receiver thread only, messages being reassembled by id and their total size
+		mutable std::unordered_map<RdId::hash_t, Buffer::ByteArray> fragments;
+		mutable size_t reassembled_bytes = 0;
+
+		std::atomic<size_t> compression_threshold{0};
+		mutable std::atomic<bool> counterpart_decompresses{false};
+		mutable std::atomic<uint64_t> compressed_packages{0};
+		mutable std::atomic<uint64_t> compressed_bytes_before{0};
+		mutable std::atomic<uint64_t> compressed_bytes_after{0};
+		// guarded by [socket_send_lock], one per package of a batch
+		mutable std::vector<Buffer::ByteArray> compression_buffers;
+		mutable std::vector<Buffer::ByteArray const*> send_batch_payloads;
+#if !defined(_WIN32)
+		mutable std::vector<iovec> send_batch_vectors;
+#endif
+		mutable Buffer::ByteArray decompression_buffer;
+
+		mutable WireMetrics metrics;
+
+		/**
+		 * \brief Compresses [package] into compression buffer [slot] if the counterpart supports it and it pays off.
+		 * \param header_length length to be written into the package header, flagged if compressed.
+		 * \return bytes to be sent after the header, either [package] or the compression buffer.
+		 */
+		Buffer::ByteArray const& compress_package(Buffer::ByteArray const& package, size_t slot, int32_t& header_length) const;
+
+		/**
+		 * \brief Whether the counterpart of the current connection reads [package], which may have been written
+		 * for the previous one and be replayed now.
+		 */
+		bool readable_by_counterpart(Buffer::ByteArray const& package) const;
+
+		/**
+		 * \brief Resumes the sender once per connection, replaying retained packages.
+		 */
+		void resume_sending() const;
+
 		/**
 		 * \brief Timestamp of this wire which increases at intervals of [heartBeatInterval].
 		 */
@@ -77,13 +192,20 @@ public:
 
 		mutable sequence_number_t max_received_seqn = 0;
 		mutable Buffer send_package_header{PACKAGE_HEADER_LENGTH};
+		mutable Buffer send_batch_buffer{PACKAGE_HEADER_LENGTH * DEFAULT_MAX_SEND_BATCH_SIZE};
 
 		static constexpr int32_t CHUNK_SIZE = 16370;
 		mutable int32_t sz = -1;
 		mutable RdId::hash_t id_ = -1;
-		mutable PkgInputStream receive_pkg{[this]() -> int32_t { return this->read_package(); }};
+		// the messages of a package are handed over to the scheduler at once, before waiting for the next one
+		mutable PkgInputStream receive_pkg{[this]() -> int32_t {
+			message_broker.end_batch();
+			const int32_t len = this->read_package();
+			message_broker.begin_batch();
+			return len;
+		}};
 
-		mutable Buffer message{CHUNK_SIZE};
+		int32_t receive_from_socket(Buffer::word_t* dst, int32_t max_len) const;
 
 		bool read_from_socket(Buffer::word_t* res, int32_t msglen) const;
 
@@ -124,11 +246,69 @@ public:
 
 		bool send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const;
 
-		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
+		/**
+		 * \brief Sends [count] consecutive packages starting with [first_seqn] with a single gathered write.
+		 */
+		bool send_batch0(Buffer::ByteArray const* const* packages, size_t count, sequence_number_t first_seqn) const;
+
+		/**
+		 * \brief Sets how many queued packages may be coalesced into one socket write, 1 disables coalescing.
+		 */
+		void set_max_send_batch_size(size_t value);
+
+		struct CompressionStats
+		{
+			uint64_t packages;
+			uint64_t bytes_before;
+			uint64_t bytes_after;
+		};
+
+		/**
+		 * \brief Packages of at least [value] bytes are sent compressed once the counterpart announced it can decompress
+		 * them, 0 (default) disables compression. Incompressible packages are sent as is.
+		 */
+		void set_compression_threshold(size_t value);
+
+		/**
+		 * \brief Totals over the packages sent compressed.
+		 */
+		CompressionStats get_compression_stats() const;
+
+		/**
+		 * \brief Messages are written with Buffer::IntegralEncoding::Compact once the counterpart announced it reads them,
+		 * false (default) keeps the fixed-width encoding. Both encodings are always accepted on receive.
+		 */
+		void set_compact_encoding(bool value);
+
+		/**
+		 * \brief Current counters of the wire, cheap enough to be polled from any thread.
+		 */
+		WireMetrics::Snapshot get_metrics() const;
+
+		/**
+		 * \brief Passes \ref get_metrics to [sink] every [period] on the shared TimerWheel until [lifetime] terminates.
+		 * Snapshots are logged at info level if [sink] is empty. [sink] must be short and must not block.
+		 */
+		void start_metrics_export(Lifetime lifetime, std::chrono::milliseconds period,
+			std::function<void(WireMetrics::Snapshot const&)> sink = nullptr) const;
+
+		using WireBase::send;
+
+		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer, size_t size_hint) const override;
+
+		/**
+		 * \brief Sends the message in fragments of about \ref FRAGMENT_SIZE once the counterpart announced it reassembles
+		 * them, otherwise builds it whole like \ref send.
+		 */
+		void send_fragmented(
+			RdId const& rd_id, std::function<void(Buffer& buffer, std::function<void()> const& flush)> writer) const override;
 
 		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
 
-		std::future<void> start_heartbeat(Lifetime lifetime);
+		/**
+		 * \brief Pings the counterpart every [heartBeatInterval] on the shared TimerWheel until [lifetime] terminates.
+		 */
+		void start_heartbeat(Lifetime lifetime);
 
 		void ping() const;
 
@@ -142,13 +322,22 @@ public:
 
 	class RD_FRAMEWORK_API Client : public Base
 	{
+		Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, std::string unix_path, const std::string& id);
+
 	public:
 		uint16_t port = 0;
 
+		/**
+		 * \brief Path of the local (AF_UNIX) socket to connect to instead of the loopback TCP port, empty for TCP.
+		 */
+		std::string unix_path;
+
 		// region ctor/dtor
 
 		Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ClientSocket");
 
+		Client(Lifetime parentLifetime, IScheduler* scheduler, std::string unix_path, const std::string& id = "ClientSocket");
+
 		virtual ~Client() override;
 		// endregion
 
@@ -159,17 +348,42 @@ public:
 
 	class RD_FRAMEWORK_API Server : public Base
 	{
+		Server(Lifetime parentLifetime, IScheduler* scheduler, std::unique_ptr<CPassiveSocket> listening, std::string unix_path,
+			const std::string& id);
+
+		/**
+		 * \brief Listens the loopback TCP [port], or the local socket at [unix_path] if it isn't empty.
+		 * \return nullptr if the socket couldn't be listened, the reason is logged.
+		 */
+		static std::unique_ptr<CPassiveSocket> open_listening(uint16_t port, std::string const& unix_path, const std::string& id);
+
 	public:
 		uint16_t port = 0;
 
+		/**
+		 * \brief Path of the local (AF_UNIX) socket listened instead of the loopback TCP port, empty for TCP.
+		 * Local sockets skip TCP checksums, congestion control and acknowledges, the file is removed on termination.
+		 */
+		std::string unix_path;
+
 		std::unique_ptr<CPassiveSocket> ss;
 
 		// region ctor/dtor
 
 		Server(Lifetime lifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ServerSocket");
 
+		Server(Lifetime lifetime, IScheduler* scheduler, std::string unix_path, const std::string& id = "ServerSocket");
+
 		virtual ~Server() override;
 		// endregion
+
+		/**
+		 * \brief Creates a server listening the local socket at [unix_path].
+		 * \return nullptr if the socket couldn't be listened, e.g. the path is too long or local sockets aren't supported,
+		 * no accepting thread is started then.
+		 */
+		static std::shared_ptr<Server> create_unix(
+			Lifetime lifetime, IScheduler* scheduler, std::string unix_path, const std::string& id = "ServerSocket");
 	private:
 		LifetimeDefinition serverLifetimeDefinition;
 	};
@@ -0,0 +1,149 @@
+#include "WireMetrics.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+
+namespace rd
+{
+constexpr size_t WireMetrics::ACK_LATENCY_BUCKETS;
+constexpr size_t WireMetrics::SEND_RECORDS;
+constexpr size_t WireMetrics::PING_RECORDS;
+
+int64_t WireMetrics::Snapshot::ack_latency_percentile_us(double fraction) const
+{
+	uint64_t total = 0;
+	for (uint64_t count : ack_latency_histogram)
+	{
+		total += count;
+	}
+	if (total == 0)
+	{
+		return -1;
+	}
+	const uint64_t threshold = static_cast<uint64_t>(fraction * static_cast<double>(total));
+	uint64_t accumulated = 0;
+	for (size_t i = 0; i < ACK_LATENCY_BUCKETS; ++i)
+	{
+		accumulated += ack_latency_histogram[i];
+		if (accumulated > threshold || accumulated == total)
+		{
+			return int64_t(1) << i;
+		}
+	}
+	return int64_t(1) << (ACK_LATENCY_BUCKETS - 1);
+}
+
+int64_t WireMetrics::now_us() const
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(clock_t::now() - start).count();
+}
+
+void WireMetrics::on_package_sent(sequence_number_t seqn, size_t bytes)
+{
+	bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+	packages_sent.fetch_add(1, std::memory_order_relaxed);
+
+	// the sequence number is invalidated while the time is updated, so a concurrent acknowledge never pairs them wrong
+	SendRecord& record = send_records[static_cast<size_t>(seqn) % SEND_RECORDS];
+	record.seqn.store(0, std::memory_order_relaxed);
+	record.time.store(now_us(), std::memory_order_release);
+	record.seqn.store(seqn, std::memory_order_release);
+}
+
+void WireMetrics::on_package_received(size_t bytes)
+{
+	bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+	packages_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WireMetrics::on_acknowledged(sequence_number_t seqn)
+{
+	acknowledges_received.fetch_add(1, std::memory_order_relaxed);
+
+	SendRecord& record = send_records[static_cast<size_t>(seqn) % SEND_RECORDS];
+	if (record.seqn.load(std::memory_order_acquire) != seqn)
+	{
+		// sent too long ago or being overwritten
+		return;
+	}
+	const int64_t sent = record.time.load(std::memory_order_acquire);
+	if (record.seqn.load(std::memory_order_acquire) != seqn)
+	{
+		return;
+	}
+	const int64_t latency = (std::max)(now_us() - sent, int64_t(0));
+	size_t bucket = 0;
+	while (bucket + 1 < ACK_LATENCY_BUCKETS && (int64_t(1) << bucket) <= latency)
+	{
+		++bucket;
+	}
+	ack_latency_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void WireMetrics::on_ping_sent(int32_t timestamp)
+{
+	ping_times[static_cast<uint32_t>(timestamp) % PING_RECORDS].store(now_us(), std::memory_order_relaxed);
+	last_sent_ping.store(timestamp, std::memory_order_release);
+}
+
+void WireMetrics::on_ping_acknowledged(int32_t timestamp)
+{
+	const int32_t sent = last_sent_ping.load(std::memory_order_acquire);
+	int32_t previous = last_acknowledged_ping.load(std::memory_order_relaxed);
+	if (timestamp <= previous || timestamp > sent)
+	{
+		// repeated acknowledge, the initial zero or a stale one from the previous connection
+		return;
+	}
+	last_acknowledged_ping.store(timestamp, std::memory_order_relaxed);
+	if (sent - timestamp < static_cast<int32_t>(PING_RECORDS))
+	{
+		const int64_t ping_time = ping_times[static_cast<uint32_t>(timestamp) % PING_RECORDS].load(std::memory_order_relaxed);
+		heartbeat_rtt_us.store(now_us() - ping_time, std::memory_order_relaxed);
+	}
+}
+
+void WireMetrics::on_connected()
+{
+	connects.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WireMetrics::on_disconnected()
+{
+	disconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+WireMetrics::Snapshot WireMetrics::snapshot() const
+{
+	Snapshot result;
+	result.bytes_sent = bytes_sent.load(std::memory_order_relaxed);
+	result.packages_sent = packages_sent.load(std::memory_order_relaxed);
+	result.bytes_received = bytes_received.load(std::memory_order_relaxed);
+	result.packages_received = packages_received.load(std::memory_order_relaxed);
+	result.acknowledges_received = acknowledges_received.load(std::memory_order_relaxed);
+	result.connects = connects.load(std::memory_order_relaxed);
+	result.disconnects = disconnects.load(std::memory_order_relaxed);
+	const int32_t sent = last_sent_ping.load(std::memory_order_relaxed);
+	const int32_t acknowledged = last_acknowledged_ping.load(std::memory_order_relaxed);
+	result.heartbeat_delay = sent < 0 ? 0 : sent - acknowledged;
+	result.heartbeat_rtt_us = heartbeat_rtt_us.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < ACK_LATENCY_BUCKETS; ++i)
+	{
+		result.ack_latency_histogram[i] = ack_latency_histogram[i].load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+std::string to_string(WireMetrics::Snapshot const& snapshot)
+{
+	return fmt::format(
+		"sent: {} packages/{} bytes, received: {} packages/{} bytes, acknowledges: {}, "
+		"queued: {}, pending: {} packages/{} bytes, connects: {}, disconnects: {}, "
+		"heartbeat delay: {}, heartbeat rtt: {}us, ack latency p50: {}us, p99: {}us",
+		snapshot.packages_sent, snapshot.bytes_sent, snapshot.packages_received, snapshot.bytes_received,
+		snapshot.acknowledges_received, snapshot.queued_packages, snapshot.pending_packages, snapshot.pending_bytes,
+		snapshot.connects, snapshot.disconnects, snapshot.heartbeat_delay, snapshot.heartbeat_rtt_us,
+		snapshot.ack_latency_percentile_us(0.5), snapshot.ack_latency_percentile_us(0.99));
+}
+}	 // namespace rd
@@ -0,0 +1,149 @@
+#ifndef RD_CPP_WIREMETRICS_H
+#define RD_CPP_WIREMETRICS_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "RetransmitWindow.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Counters of a single wire. All of them are lock-free and updated with relaxed atomics from the threads
+ * of the wire, so they can be read at any moment from any thread at no cost for the wire.
+ */
+class RD_FRAMEWORK_API WireMetrics
+{
+public:
+	using clock_t = std::chrono::steady_clock;
+
+	/**
+	 * \brief Bucket i of the ACK latency histogram counts latencies in [2^(i-1), 2^i) microseconds,
+	 * the first one counts latencies below 1us, the last one everything above.
+	 */
+	static constexpr size_t ACK_LATENCY_BUCKETS = 24;
+
+	struct Snapshot
+	{
+		uint64_t bytes_sent = 0;
+		uint64_t packages_sent = 0;
+		uint64_t bytes_received = 0;
+		uint64_t packages_received = 0;
+		uint64_t acknowledges_received = 0;
+
+		uint64_t connects = 0;
+		uint64_t disconnects = 0;
+
+		/**
+		 * \brief Packages put into the wire but not sent yet.
+		 */
+		size_t queued_packages = 0;
+		/**
+		 * \brief Packages sent but not acknowledged yet, they are replayed after reconnect.
+		 */
+		size_t pending_packages = 0;
+		size_t pending_bytes = 0;
+
+		/**
+		 * \brief How many heartbeats the counterpart's acknowledge lags behind, the connection is considered dead
+		 * once it exceeds the wire's MaximumHeartbeatDelay.
+		 */
+		int32_t heartbeat_delay = 0;
+		/**
+		 * \brief Time from sending the latest acknowledged PING to receiving its acknowledge, -1 if unknown.
+		 * The counterpart acknowledges timestamps with its own PINGs, so it's an upper bound of the actual round trip.
+		 */
+		int64_t heartbeat_rtt_us = -1;
+
+		std::array<uint64_t, ACK_LATENCY_BUCKETS> ack_latency_histogram{};
+
+		/**
+		 * \brief Upper bound of the ACK latency in microseconds not exceeded by [fraction] of packages, -1 if none were acknowledged.
+		 */
+		int64_t ack_latency_percentile_us(double fraction) const;
+	};
+
+private:
+	// send times of the latest sent packages by their sequence numbers
+	static constexpr size_t SEND_RECORDS = 1024;
+	static constexpr size_t PING_RECORDS = 16;
+
+	struct SendRecord
+	{
+		std::atomic<sequence_number_t> seqn{0};
+		std::atomic<int64_t> time{0};
+	};
+
+	const clock_t::time_point start = clock_t::now();
+
+	std::atomic<uint64_t> bytes_sent{0};
+	std::atomic<uint64_t> packages_sent{0};
+	std::atomic<uint64_t> bytes_received{0};
+	std::atomic<uint64_t> packages_received{0};
+	std::atomic<uint64_t> acknowledges_received{0};
+	std::atomic<uint64_t> connects{0};
+	std::atomic<uint64_t> disconnects{0};
+
+	std::array<SendRecord, SEND_RECORDS> send_records;
+	std::array<std::atomic<uint64_t>, ACK_LATENCY_BUCKETS> ack_latency_histogram{};
+
+	std::array<std::atomic<int64_t>, PING_RECORDS> ping_times{};
+	std::atomic<int32_t> last_sent_ping{-1};
+	std::atomic<int32_t> last_acknowledged_ping{0};
+	std::atomic<int64_t> heartbeat_rtt_us{-1};
+
+	int64_t now_us() const;
+
+public:
+	// region ctor/dtor
+
+	WireMetrics() = default;
+
+	WireMetrics(WireMetrics const&) = delete;
+
+	WireMetrics& operator=(WireMetrics const&) = delete;
+	// endregion
+
+	/**
+	 * \brief [bytes] include the package header.
+	 */
+	void on_package_sent(sequence_number_t seqn, size_t bytes);
+
+	void on_package_received(size_t bytes);
+
+	void on_acknowledged(sequence_number_t seqn);
+
+	void on_ping_sent(int32_t timestamp);
+
+	/**
+	 * \brief Called with the counterpart's notion of this wire's timestamp received with every PING.
+	 */
+	void on_ping_acknowledged(int32_t timestamp);
+
+	void on_connected();
+
+	void on_disconnected();
+
+	/**
+	 * \brief Fills the counters of the wire, the queues are filled by the wire owning them.
+	 */
+	Snapshot snapshot() const;
+};
+
+std::string RD_FRAMEWORK_API to_string(WireMetrics::Snapshot const& snapshot);
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_WIREMETRICS_H
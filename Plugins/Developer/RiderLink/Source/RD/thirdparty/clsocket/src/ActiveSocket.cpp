@@ -308,3 +308,45 @@ bool CActiveSocket::Open(const char *pAddr, uint16_t nPort)
 
     return bRetVal;
 }
+
+
+//------------------------------------------------------------------------------
+//
+// OpenUnix() - Create a connection to a local socket on a specified path
+//
+//------------------------------------------------------------------------------
+bool CActiveSocket::OpenUnix(const char *pPath)
+{
+    bool bRetVal = false;
+    struct sockaddr_un stUnixSockaddr;
+
+    if (IsSocketValid() == false)
+    {
+        SetSocketError(CSimpleSocket::SocketInvalidSocket);
+        return bRetVal;
+    }
+
+    memset(&stUnixSockaddr, 0, sizeof(stUnixSockaddr));
+    stUnixSockaddr.sun_family = AF_UNIX;
+
+    if ((pPath == NULL) || (strlen(pPath) >= sizeof(stUnixSockaddr.sun_path)))
+    {
+        SetSocketError(CSimpleSocket::SocketInvalidAddress);
+        return bRetVal;
+    }
+    strncpy(stUnixSockaddr.sun_path, pPath, sizeof(stUnixSockaddr.sun_path) - 1);
+
+    m_timer.Initialize();
+    m_timer.SetStartTime();
+
+    if (connect(m_socket, (struct sockaddr *)&stUnixSockaddr, sizeof(stUnixSockaddr)) != CSimpleSocket::SocketError)
+    {
+        bRetVal = true;
+    }
+
+    TranslateSocketError();
+
+    m_timer.SetEndTime();
+
+    return bRetVal;
+}
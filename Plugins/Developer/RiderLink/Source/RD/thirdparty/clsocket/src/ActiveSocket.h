@@ -75,6 +75,12 @@ public:
     ///  @return true if successful connection made, otherwise false.
     virtual bool Open(const char *pAddr, uint16_t nPort);
 
+    /// Established a connection to the local new_socket listening on the file
+    /// system path pPath, the new_socket must be of type CSimpleSocket::SocketTypeUnix.
+    ///  @param pPath specifies the path of the listening new_socket.
+    ///  @return true if successful connection made, otherwise false.
+    virtual bool OpenUnix(const char *pPath);
+
 private:
     /// Utility function used to create a TCP connection, called from Open().
     ///  @return true if successful connection made, otherwise false.
@@ -192,6 +192,47 @@ bool CPassiveSocket::Listen(const char *pAddr, uint16_t nPort, int32_t nConnecti
 }
 
 
+//------------------------------------------------------------------------------
+//
+// ListenUnix() -
+//
+//------------------------------------------------------------------------------
+bool CPassiveSocket::ListenUnix(const char *pPath, int32_t nConnectionBacklog) {
+    bool bRetVal = false;
+    struct sockaddr_un stUnixSockaddr;
+
+    memset(&stUnixSockaddr, 0, sizeof(stUnixSockaddr));
+    stUnixSockaddr.sun_family = AF_UNIX;
+
+    if ((pPath == NULL) || (strlen(pPath) >= sizeof(stUnixSockaddr.sun_path))) {
+        SetSocketError(CSimpleSocket::SocketInvalidAddress);
+        return bRetVal;
+    }
+    strncpy(stUnixSockaddr.sun_path, pPath, sizeof(stUnixSockaddr.sun_path) - 1);
+
+    m_timer.Initialize();
+    m_timer.SetStartTime();
+
+    if (bind(m_socket, (struct sockaddr *) &stUnixSockaddr, sizeof(stUnixSockaddr)) != CSimpleSocket::SocketError) {
+        if (listen(m_socket, nConnectionBacklog) != CSimpleSocket::SocketError) {
+            bRetVal = true;
+        }
+    }
+
+    m_timer.SetEndTime();
+
+    TranslateSocketError();
+
+    if (bRetVal == false) {
+        CSocketError err = GetSocketError();
+        Close();
+        SetSocketError(err);
+    }
+
+    return bRetVal;
+}
+
+
 //------------------------------------------------------------------------------
 //
 // Accept() -
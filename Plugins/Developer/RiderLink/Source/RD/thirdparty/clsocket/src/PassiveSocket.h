@@ -97,6 +97,17 @@ public:
     ///      derived systems only: CPassiveSocket::SocketInvalidSocketBuffer
     virtual bool Listen(const char *pAddr, uint16_t nPort, int32_t nConnectionBacklog = 30000);
 
+    /// Create a listening new_socket bound to the file system path pPath, the new_socket
+    /// must be of type CSimpleSocket::SocketTypeUnix.  The caller is responsible for
+    /// removing a stale file at pPath before and after listening.
+    ///
+    ///  @param pPath specifies the path on which to listen.
+    ///  @param nConnectionBacklog specifies connection queue backlog (default 30,000)
+    ///  @return true if a listening new_socket was created, otherwise false and
+    ///      CPassiveSocket::SocketInvalidAddress if the path is too long or the
+    ///      error of the failed call is set.
+    virtual bool ListenUnix(const char *pPath, int32_t nConnectionBacklog = 30000);
+
     /// Attempts to send a block of data on an established connection.
     /// @param pBuf block of data to be sent.
     /// @param bytesToSend size of data block to be sent.
@@ -88,6 +88,15 @@ CSimpleSocket::CSimpleSocket(CSocketType nType) :
         break;
     }
     //----------------------------------------------------------------------
+    // Declare socket type local stream - behaves as TCP except for addressing
+    //----------------------------------------------------------------------
+    case CSimpleSocket::SocketTypeUnix:
+    {
+        m_nSocketDomain = AF_UNIX;
+        m_nSocketType = CSimpleSocket::SocketTypeTcp;
+        break;
+    }
+    //----------------------------------------------------------------------
     // Declare socket type raw Ethernet - Ethernet
     //----------------------------------------------------------------------
     case CSimpleSocket::SocketTypeRaw:
@@ -56,6 +56,7 @@
 #include <netinet/tcp.h>
 #include <netinet/ip.h>
 #include <netdb.h>
+#include <sys/un.h>
 #endif
 #ifdef __linux__
 #include <linux/if_packet.h>
@@ -79,6 +80,7 @@
 	#include <io.h>
 	#include <winsock2.h>
 	#include <Ws2tcpip.h>
+	#include <afunix.h>
 #pragma warning( pop )
 
 #define IPTOS_LOWDELAY  0x10
@@ -120,7 +122,8 @@ public:
         SocketTypeUdp,       ///< Defines socket as UDP socket.
         SocketTypeTcp6,      ///< Defines socket as IPv6 TCP socket.
         SocketTypeUdp6,      ///< Defines socket as IPv6 UDP socket.
-        SocketTypeRaw        ///< Provides raw network protocol access.
+        SocketTypeRaw,       ///< Provides raw network protocol access.
+        SocketTypeUnix       ///< Defines socket as local (AF_UNIX) stream socket, handled as TCP one.
     } CSocketType;
 
     /// Defines all error codes handled by the CSimpleSocket class.
@@ -561,7 +564,7 @@ protected:
     CSocketError         m_socketErrno;       /// number of last error
     uint8_t               *m_pBuffer;           /// internal send/receive buffer
     int32_t                m_nBufferSize;       /// size of internal send/receive buffer
-    int32_t                m_nSocketDomain;     /// socket type PF_INET, PF_INET6
+    int32_t                m_nSocketDomain;     /// socket type PF_INET, PF_INET6, PF_UNIX
     CSocketType          m_nSocketType;       /// socket type - UDP, TCP or RAW
     int32_t                m_nBytesReceived;    /// number of bytes received
     int32_t                m_nBytesSent;        /// number of bytes sent
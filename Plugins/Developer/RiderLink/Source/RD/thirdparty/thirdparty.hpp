@@ -52,6 +52,7 @@ namespace rd
 {
 using nonstd::string_view;
 using nonstd::wstring_view;
+using nonstd::u16string_view;
 using namespace std::literals;
 using namespace nonstd::literals;
 }	 // namespace rd
@@ -10,6 +10,7 @@
 #else
 #include "HAL/PlatformFilemanager.h"
 #endif
+#include "HAL/PlatformProcess.h"
 #include "Misc/App.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
@@ -66,6 +67,13 @@ static FString GetPathToPortsFolder()
     return FPaths::Combine(*MiscFilesFolder, TEXT("Ports"));
 }
 
+static FString GetUnixSocketPath()
+{
+    // sockaddr_un limits the path to ~100 bytes, so keep it short instead of using the project name
+    return FPaths::Combine(FPlatformProcess::UserTempDir(),
+                           FString::Printf(TEXT("RiderLink-%u.sock"), FPlatformProcess::GetCurrentProcessId()));
+}
+
 static FString GetLogFile(const FString& projectName)
 {
     const FString MiscFilesFolder = GetMiscFilesFolder();
@@ -94,9 +102,19 @@ void ProtocolFactory::InitRdLogging()
 
 std::shared_ptr<rd::SocketWire::Server> ProtocolFactory::CreateWire(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime)
 {
-    return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0,
-                                                         TCHAR_TO_UTF8(*FString::Printf(TEXT("UnrealEditorServer-%s"),
-                                                             *ProjectName)));
+    const std::string Id = TCHAR_TO_UTF8(*FString::Printf(TEXT("UnrealEditorServer-%s"), *ProjectName));
+#if defined(ENABLE_UNIX_SOCKET) && ENABLE_UNIX_SOCKET == 1
+    {
+        const std::string SocketPath = TCHAR_TO_UTF8(*GetUnixSocketPath());
+        auto Wire = rd::SocketWire::Server::create_unix(SocketLifetime, Scheduler, SocketPath, Id);
+        if (Wire != nullptr)
+        {
+            return Wire;
+        }
+        // the path is too long or local sockets aren't supported, fall back to loopback TCP
+    }
+#endif
+    return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0, Id);
 }
 
 
@@ -111,7 +129,10 @@ TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Schedul
         const FString ProjectFileName = ProjectName + TEXT(".uproject");
         const FString TmpPortFile = TEXT("~") + ProjectFileName;
         const FString TmpPortFileFullPath = FPaths::Combine(*PortFullDirectoryPath, *TmpPortFile);
-        FFileHelper::SaveStringToFile(FString::FromInt(wire->port), *TmpPortFileFullPath);
+        const FString Endpoint = wire->unix_path.empty()
+                                     ? FString::FromInt(wire->port)
+                                     : TEXT("unix:") + FString(UTF8_TO_TCHAR(wire->unix_path.c_str()));
+        FFileHelper::SaveStringToFile(Endpoint, *TmpPortFileFullPath);
         const FString PortFileFullPath = FPaths::Combine(*PortFullDirectoryPath, *ProjectFileName);
         IFileManager::Get().Move(*PortFileFullPath, *TmpPortFileFullPath, true, true);
     }
@@ -9,16 +9,22 @@
 namespace rd {
 
     FString Polymorphic<FString, void>::read(SerializationCtx& ctx, Buffer& buffer) {
-        UCS2CHAR * str = buffer.read_char16_string();
-        FString tmp{str};
-        delete str;
-        return tmp;
+        // constructed right from the message bytes, the only allocation is the string itself
+        const u16string_view str = buffer.read_char16_view();
+        if (str.empty()) {
+            return FString();
+        }
+        return FString(static_cast<int32>(str.size()), reinterpret_cast<const UCS2CHAR*>(str.data()));
     }
 
     void Polymorphic<FString, void>::write(SerializationCtx& ctx, Buffer& buffer, FString const& value) {
         buffer.write_char16_string(reinterpret_cast<const uint16_t*>(GetData(value)), value.Len());
     }
 
+    size_t Polymorphic<FString, void>::estimate_size(SerializationCtx& ctx, FString const& value) {
+        return sizeof(int32_t) + sizeof(uint16_t) * value.Len();
+    }
+
 
     size_t hash<FString>::operator()(const FString& value) const noexcept {
         return GetTypeHash(value);
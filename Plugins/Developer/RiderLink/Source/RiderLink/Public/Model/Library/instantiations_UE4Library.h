@@ -48,6 +48,10 @@ public:
             buffer.write_integral<int32_t>(static_cast<int32_t>(value));
         }
     }
+
+    static size_t estimate_size(SerializationCtx& ctx, ELogVerbosity::Type const& value) {
+        return sizeof(int32_t);
+    }
 };
 
 extern template class Polymorphic<ELogVerbosity::Type>;
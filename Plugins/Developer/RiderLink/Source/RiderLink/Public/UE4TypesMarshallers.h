@@ -31,12 +31,18 @@ namespace rd {
         static FString read(SerializationCtx& ctx, Buffer& buffer);
 
         static void write(SerializationCtx& ctx, Buffer& buffer, FString const& value);
+
+        static size_t estimate_size(SerializationCtx& ctx, FString const& value);
     };
 
     template <>
     class Polymorphic<Wrapper<FString>> {
     public:
         static void write(SerializationCtx& ctx, Buffer& buffer, Wrapper<FString> const& value);
+
+        static size_t estimate_size(SerializationCtx& ctx, Wrapper<FString> const& value) {
+            return value ? Polymorphic<FString>::estimate_size(ctx, *value) : 0;
+        }
     };
 
     template <>
@@ -21,6 +21,8 @@ public class RiderLink : ModuleRules
 		};
 		
 		PrivateDefinitions.Add("ENABLE_LOG_FILE=0");
+		// Listen on a local (AF_UNIX) socket advertised as "unix:<path>" in the port file instead of a TCP port
+		PrivateDefinitions.Add("ENABLE_UNIX_SOCKET=0");
 
 		foreach(var Item in Paths)
 		{